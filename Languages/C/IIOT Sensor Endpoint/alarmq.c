@@ -0,0 +1,332 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Outbound alarm queue. alarm_send transmits a datagram to the master controller and
+    waits for the W5x to finish it, and it used to be called straight from the temperature FSM, so a
+    temperature flapping across a threshold sent one alarm per flap from inside the sampling task.
+    Alarms are now posted to this queue and sent by the alarmq_update task, at most one per run, so
+    the executive is never held up by more than one send per ALARMQ_PERIOD_MS however many alarms
+    are raised.
+
+    The queue holds at most one entry per event, in the order the events were first posted. An
+    alarm posted while one of the same event is still queued is merged into it; the alarm library
+    sends only the event code, so the merged alarms are counted here (see alarmq_merged). After an
+    event is sent, the same event is held back for the hold-off of its class
+    (ALARMQ_CRIT_HOLDOFF_MS for the alarm events, ALARMQ_WARN_HOLDOFF_MS for the warnings, none for
+    the system events); alarms raised meanwhile wait in the queue, merged into one entry, and are
+    sent once when the hold-off ends. A held-back entry does not block the entries behind it,
+    except those for the same side of the band, so the master controller's latest alarm for a side
+    is always the latest one raised. Because there is one entry per event, the queue cannot
+    overflow and no alarm is dropped, only merged.
+
+    The two hold-offs differ, so a warning held back could otherwise be sent after a critical alarm
+    for the same side raised later, and leave the master controller with an alarm that understates
+    the temperature. A critical alarm therefore takes the place of a warning for its side that is
+    still queued: the warning is merged into it, as the critical alarm reports more.
+**/
+
+//INCLUDES:
+#include "alarm.h"
+#include "log.h"
+#include "sched.h"
+#include "alarmq.h"
+
+//DEFINES:
+#define ALARMQ_EVENTS   (EVENT_LO_ALARM + 1)    //Event codes, indexed directly; 0 is unused
+
+//DECLARATIONS:
+static unsigned char queue[ALARMQ_EVENTS];          //Queued events, oldest first
+static unsigned char queueLen;
+static unsigned long lastSent[ALARMQ_EVENTS];       //sched_now() of the last send, by event
+static unsigned char everSent[ALARMQ_EVENTS];       //The event has been sent since init
+static unsigned long postedCount;
+static unsigned long mergedCount;
+
+/**
+Function Name : holdoff
+
+Description : Returns the hold-off of an event's class.
+
+Arguments :
+    (unsigned char) eventnum - The event code.
+
+Returns :
+    (unsigned int) - Milliseconds the event is held back after it was sent.
+
+Changes :
+    N/A
+**/
+static unsigned int holdoff(unsigned char eventnum) {
+    switch (eventnum) {
+        case EVENT_HI_ALARM :
+        case EVENT_LO_ALARM :
+            return ALARMQ_CRIT_HOLDOFF_MS;
+        case EVENT_HI_WARN :
+        case EVENT_LO_WARN :
+            return ALARMQ_WARN_HOLDOFF_MS;
+        default :
+            return 0;
+    }
+}
+
+/**
+Function Name : side
+
+Description : Returns the side of the band an event is raised for.
+
+Arguments :
+    (unsigned char) eventnum - The event code.
+
+Returns :
+    (unsigned char) - EVENT_HI_ALARM for the high alarm and warning, EVENT_LO_ALARM for the low
+        ones, or 0 for the system events.
+
+Changes :
+    N/A
+**/
+static unsigned char side(unsigned char eventnum) {
+    switch (eventnum) {
+        case EVENT_HI_ALARM :
+        case EVENT_HI_WARN :
+            return EVENT_HI_ALARM;
+        case EVENT_LO_ALARM :
+        case EVENT_LO_WARN :
+            return EVENT_LO_ALARM;
+        default :
+            return 0;
+    }
+}
+
+/**
+Function Name : removeEntry
+
+Description : Removes the queued entry at an index, keeping the order of the others.
+
+Arguments :
+    (unsigned char) index - The position of the entry in the queue.
+
+Returns :
+    void
+
+Changes :
+    Alarm queue - The entry is removed.
+**/
+static void removeEntry(unsigned char index) {
+    queueLen--;
+    for (; index < queueLen; index++) {
+        queue[index] = queue[index + 1];
+    }
+}
+
+/**
+Function Name : sendEntry
+
+Description : Sends the queued entry at an index and removes it from the queue.
+
+Arguments :
+    (unsigned char) index - The position of the entry in the queue.
+
+Returns :
+    void
+
+Changes :
+    Alarm - The entry's event is sent to the master controller.
+    Alarm queue - The entry is removed and the event's hold-off started.
+**/
+static void sendEntry(unsigned char index) {
+    unsigned char eventnum = queue[index];
+
+    alarm_send(eventnum);
+    lastSent[eventnum] = sched_now();
+    everSent[eventnum] = 1;
+    removeEntry(index);
+}
+
+/**
+Function Name : alarmq_init
+
+Description : Empties the queue and forgets when each event was last sent.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Alarm queue - The queue, the send history and the counts are reset.
+**/
+void alarmq_init(void) {
+    unsigned char i;
+
+    queueLen = 0;
+    for (i = 0; i < ALARMQ_EVENTS; i++) {
+        everSent[i] = 0;
+    }
+    postedCount = 0;
+    mergedCount = 0;
+}
+
+/**
+Function Name : alarmq_post
+
+Description : Queues an alarm for the master controller, or merges it into the queued entry of the
+    same event. A critical alarm also takes the place of a queued warning for the same side, which
+    is merged into it. Returns at once; the alarm is sent by alarmq_update.
+
+Arguments :
+    (unsigned char) eventnum - The EVENT_ code of the alarm.
+
+Returns :
+    void
+
+Changes :
+    Alarm queue - An entry is added, or the alarm is counted as merged into the queued entry; a
+        warning superseded by a critical alarm is removed and counted as merged.
+**/
+void alarmq_post(unsigned char eventnum) {
+    unsigned char i;
+
+    if (eventnum == 0 || eventnum >= ALARMQ_EVENTS) {
+        return;
+    }
+    postedCount++;
+    for (i = 0; i < queueLen; i++) {
+        if (queue[i] == eventnum) {
+            mergedCount++;
+            return;
+        }
+    }
+    if (eventnum == side(eventnum)) {
+        for (i = 0; i < queueLen; i++) {
+            if (side(queue[i]) == eventnum) {
+                removeEntry(i);
+                mergedCount++;
+                break;
+            }
+        }
+    }
+    queue[queueLen++] = eventnum;
+}
+
+/**
+Function Name : alarmq_update
+
+Description : Scheduled every ALARMQ_PERIOD_MS. Sends the oldest queued alarm whose event is past its
+    hold-off, if there is one, unless an older alarm for the same side is still held back.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Alarm - At most one alarm is sent.
+    Alarm queue - The alarm sent is removed from the queue.
+**/
+void alarmq_update(void) {
+    unsigned long now;
+    unsigned char held = 0;     //Sides with an alarm held back, as bits (1 << side)
+    unsigned char i;
+
+    if (queueLen == 0) {
+        return;
+    }
+    now = sched_now();
+    for (i = 0; i < queueLen; i++) {
+        if (!(held & (1 << side(queue[i]))) &&
+                (!everSent[queue[i]] || now - lastSent[queue[i]] >= holdoff(queue[i]))) {
+            sendEntry(i);
+            return;
+        }
+        if (side(queue[i]) != 0) {
+            held |= 1 << side(queue[i]);
+        }
+    }
+}
+
+/**
+Function Name : alarmq_flush
+
+Description : Sends every queued alarm at once, held back or not. Used before a restart, which would
+    otherwise lose them.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Alarm - Every queued alarm is sent.
+    Alarm queue - The queue is emptied.
+**/
+void alarmq_flush(void) {
+    while (queueLen > 0) {
+        sendEntry(0);
+    }
+}
+
+/**
+Function Name : alarmq_pending
+
+Description : Returns the number of entries in the queue.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - The number of queued entries, at most one per event.
+
+Changes :
+    N/A
+**/
+unsigned char alarmq_pending(void) {
+    return queueLen;
+}
+
+/**
+Function Name : alarmq_posted
+
+Description : Returns the number of alarms posted since alarmq_init.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - The number of alarms posted.
+
+Changes :
+    N/A
+**/
+unsigned long alarmq_posted(void) {
+    return postedCount;
+}
+
+/**
+Function Name : alarmq_merged
+
+Description : Returns the number of posted alarms that were merged into an entry already queued
+    instead of being sent on their own.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - The number of merged alarms.
+
+Changes :
+    N/A
+**/
+unsigned long alarmq_merged(void) {
+    return mergedCount;
+}
@@ -0,0 +1,39 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for alarmq.c; the outbound alarm queue. Alarms are posted without waiting
+    for the network and sent to the master controller by a scheduled task, one per run, with
+    repeats of an event merged and each event class held to a minimum interval between sends.
+**/
+#ifndef ALARMQ_H_INCLUDED
+#define ALARMQ_H_INCLUDED
+
+//DEFINES:
+#define ALARMQ_PERIOD_MS        50      //Time between runs of the sending task
+#define ALARMQ_CRIT_HOLDOFF_MS  1000    //Least time between two sends of the same critical alarm
+#define ALARMQ_WARN_HOLDOFF_MS  10000   //Least time between two sends of the same warning
+
+//DECLARATIONS:
+void alarmq_init(void);     //Start with an empty queue and no send history
+
+void alarmq_post(unsigned char eventnum);   //Queue an alarm, merging it with a queued one of the same event
+
+void alarmq_update(void);   //Scheduled task: send the oldest queued alarm that is not held back
+
+void alarmq_flush(void);    //Send every queued alarm now, ignoring the hold-off; used before a restart
+
+unsigned char alarmq_pending(void);     //Alarms queued and not yet sent
+
+unsigned long alarmq_posted(void);  //Alarms posted since init
+
+unsigned long alarmq_merged(void);  //Posted alarms merged into one already queued
+
+#endif
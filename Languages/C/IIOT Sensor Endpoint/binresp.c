@@ -0,0 +1,118 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Binary form of the GET /device response (layout in binresp.h). It carries the same
+    data as the JSON document but as raw fields, so nothing is formatted: no quoted keys, no
+    decimal conversion and no calendar conversion of the timestamps. The whole body is about 150
+    bytes and is written in one pass.
+**/
+
+//INCLUDES:
+#include "vpd.h"
+#include "log.h"
+#include "config.h"
+#include "socket.h"
+#include "parser.h"
+#include "tempfsm.h"
+#include "strbuf.h"
+#include "binresp.h"
+
+/**
+Function Name : putU16 / putU32
+
+Description : Append a 16 or 32 bit value, least significant byte first.
+
+Arguments :
+    (strbuf*) out - The buffer to write to.
+    (unsigned int / unsigned long) value - The value to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void putU16(strbuf* out, unsigned int value) {
+    strbuf_putc(out, (char)value);
+    strbuf_putc(out, (char)(value >> 8));
+}
+
+static void putU32(strbuf* out, unsigned long value) {
+    putU16(out, (unsigned int)value);
+    putU16(out, (unsigned int)(value >> 16));
+}
+
+/**
+Function Name : binresp_size
+
+Description : Returns the size of the response body, which depends only on the number of log records.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned int) - The size of the body in bytes.
+
+Changes :
+    N/A
+**/
+unsigned int binresp_size(void) {
+    return BINRESP_HEADER_SIZE + log_get_num_entries() * BINRESP_RECORD_SIZE;
+}
+
+/**
+Function Name : binresp_write
+
+Description : Writes the binary response body: VPD, config thresholds, temperature and state, and
+    every log record.
+
+Arguments :
+    (strbuf*) out - The response writer, attached to the socket being answered.
+
+Returns :
+    void
+
+Changes :
+    Ethernet - Writes the response body through the response writer.
+**/
+void binresp_write(strbuf* out) {
+    unsigned char count = log_get_num_entries();
+    unsigned long time = 0;
+    unsigned char event = 0;
+    unsigned char i;
+
+    strbuf_putbuf(out, "TS", 2);
+    strbuf_putc(out, BINRESP_VERSION);
+    strbuf_putc(out, count);
+
+    strbuf_putbuf(out, vpd.model, sizeof(vpd.model));
+    strbuf_putbuf(out, vpd.manufacturer, sizeof(vpd.manufacturer));
+    strbuf_putbuf(out, vpd.serial_number, sizeof(vpd.serial_number));
+    putU32(out, vpd.manufacture_date);
+    strbuf_putbuf(out, (char*)vpd.mac_address, sizeof(vpd.mac_address));
+    strbuf_putbuf(out, vpd.country_of_origin, sizeof(vpd.country_of_origin));
+
+    putU16(out, config.hi_alarm);
+    putU16(out, config.hi_warn);
+    putU16(out, config.lo_alarm);
+    putU16(out, config.lo_warn);
+
+    putU16(out, tempfsm_get_temperature());
+    strbuf_putc(out, tempfsm_get_state());
+    strbuf_putc(out, 0);
+    putU32(out, log_get_first_seq());
+
+    for (i = 0; i < count; i++) {
+        log_get_record(i, &time, &event);
+        putU32(out, time);
+        strbuf_putc(out, event);
+    }
+}
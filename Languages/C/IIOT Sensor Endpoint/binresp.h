@@ -0,0 +1,50 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for binresp.c; the binary form of the GET /device response, served for
+    GET /device.bin or a GET /device that accepts application/octet-stream. Every field is at a
+    fixed offset, multi-byte fields are little endian and strings are NUL padded, so a client can
+    read the fields in place.
+
+    Offset  Size  Field
+    0       2     Magic "TS"
+    2       1     Layout version (BINRESP_VERSION)
+    3       1     Number of log records that follow (n)
+    4       12    VPD model
+    16      12    VPD manufacturer
+    28      12    VPD serial number
+    40      4     VPD manufacture date, seconds since 1970
+    44      6     VPD MAC address
+    50      4     VPD country of origin
+    54      2     tcrit_hi, signed
+    56      2     twarn_hi, signed
+    58      2     tcrit_lo, signed
+    60      2     twarn_lo, signed
+    62      2     Temperature, signed
+    64      1     Temperature state, TEMP_LOW_CRITICAL (0) to TEMP_HIGH_CRITICAL (4)
+    65      1     Reserved, 0
+    66      4     Sequence number of the first log record
+    70      5n    Log records, oldest first: time (4, seconds since 1970), event (1)
+**/
+#ifndef BINRESP_H_INCLUDED
+#define BINRESP_H_INCLUDED
+
+//DEFINES:
+#define BINRESP_VERSION         1
+#define BINRESP_HEADER_SIZE     70      /* bytes before the log records */
+#define BINRESP_RECORD_SIZE     5
+
+//DECLARATIONS:
+unsigned int binresp_size(void);    //Size in bytes of the response body for the current log
+
+void binresp_write(strbuf* out);    //Write the response body
+
+#endif
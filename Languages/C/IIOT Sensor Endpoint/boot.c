@@ -0,0 +1,220 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Fast boot after a requested restart. A start used to wait for a DHCP lease and then
+    for NTP (up to 5 tries) before the server sockets were opened, so every PUT /device?reset="true"
+    left the endpoint deaf for the length of both exchanges. The restart path in main.c now caches
+    the lease in use and the RTC time in an EEPROM block at BOOT_ADDR just before the restart.
+
+    The next start uses the block up: it configures the Ethernet controller with the cached lease,
+    sets the RTC to the cached time, and leaves NTP to boot_sync_update, which the executive runs as
+    a scheduled task once the server is listening. The log marks the records stamped between the
+    TIMESET record of such a start and its NEWTIME record as provisional (see log_get_provisional).
+
+    The block is erased as it is read, so only the start right after a requested restart is fast: a
+    power-on or a watchdog timeout, which may mean the network has changed under the endpoint, goes
+    through DHCP and NTP as before.
+
+    The board library's NTP client blocks until the server answers or its reply timeout runs out, and
+    it offers no way to send the request and poll for the answer, so a background attempt stalls the
+    pass that makes it. Each attempt is therefore a single try, taking at most BOOT_NTP_TRY_MS, which
+    must stay well inside the watchdog timeout, and the watchdog is reset just before it so the rest
+    of the pass does not count against it. The attempts are BOOT_SYNC_RETRY_MS apart, and the gap
+    doubles after each one that fails, up to BOOT_SYNC_BACKOFF_MAX retry periods, so an unreachable
+    server stalls the executive for one reply timeout every few minutes rather than every few seconds.
+**/
+
+//INCLUDES:
+#include "eeprom.h"
+#include "rtc.h"
+#include "ntp.h"
+#include "log.h"
+#include "wdt.h"
+#include "strbuf.h"
+#include "stats.h"
+#include "boot.h"
+
+//DEFINES:
+#define BOOT_ADDR       0x105   //EEPROM address of the boot cache, after the filter settings
+#define BOOT_TOKEN      0x42    //Marks a boot cache written by boot_save
+#define BOOT_BLOCK_SIZE 17      //token, ip (4), gateway (4), subnet (4), time (4)
+#define BOOT_LEASE_SIZE 12      //ip, gateway and subnet, as cached
+
+#if BOOT_NTP_TRY_MS > STATS_WDT_TIMEOUT_MS / 2
+#error "an NTP try must take well under the watchdog timeout"
+#endif
+
+//DECLARATIONS:
+static unsigned char lease[BOOT_LEASE_SIZE];    //Lease in use: ip, gateway, subnet
+static unsigned char synced;    //The clock has been synchronized since the fast boot
+static unsigned char backoff;   //Retry periods skipped after the last failed attempt
+static unsigned char skip;      //Retry periods still to skip before the next attempt
+
+/**
+Function Name : boot_restore
+
+Description : Reads the boot cache and erases its token, so it serves one start only. If the cache
+    was valid, its lease becomes the lease in use and the RTC is set to its time.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - 1 for a fast boot, which skips DHCP and NTP; 0 if the cache was not valid.
+
+Changes :
+    EEPROM - The token of a valid boot cache is erased.
+    RTC - Set to the cached time on a fast boot.
+    Boot - The cached lease is in use on a fast boot, and the clock is not yet synchronized.
+**/
+unsigned char boot_restore(void) {
+    unsigned char block[BOOT_BLOCK_SIZE];
+    unsigned long time;
+    unsigned char i;
+
+    synced = 1;
+    backoff = 0;
+    skip = 0;
+    eeprom_readbuf(BOOT_ADDR, block, BOOT_BLOCK_SIZE);
+    if (block[0] != BOOT_TOKEN) {
+        return 0;
+    }
+    block[0] = 0;
+    eeprom_writebuf(BOOT_ADDR, block, 1);
+
+    for (i = 0; i < BOOT_LEASE_SIZE; i++) {
+        lease[i] = block[1 + i];
+    }
+    time = (unsigned long)block[13] | ((unsigned long)block[14] << 8) |
+        ((unsigned long)block[15] << 16) | ((unsigned long)block[16] << 24);
+    rtc_set_by_datestr(rtc_num2datestr(time));
+    synced = 0;
+    return 1;
+}
+
+/**
+Function Name : boot_set_lease
+
+Description : Keeps the lease handed out by DHCP as the lease in use, for the Ethernet controller
+    and for boot_save.
+
+Arguments :
+    (unsigned char*) ip - The local address, 4 bytes.
+    (unsigned char*) gateway - The gateway address, 4 bytes.
+    (unsigned char*) subnet - The subnet mask, 4 bytes.
+
+Returns :
+    void
+
+Changes :
+    Boot - The lease in use is replaced.
+**/
+void boot_set_lease(unsigned char* ip, unsigned char* gateway, unsigned char* subnet) {
+    unsigned char i;
+
+    for (i = 0; i < 4; i++) {
+        lease[i] = ip[i];
+        lease[4 + i] = gateway[i];
+        lease[8 + i] = subnet[i];
+    }
+}
+
+/**
+Function Name : boot_local_ip / boot_gateway_ip / boot_subnet_mask
+
+Description : Return the parts of the lease in use, 4 bytes each, as dhcp_getLocalIp,
+    dhcp_getGatewayIp and dhcp_getSubnetMask do after DHCP.
+**/
+unsigned char* boot_local_ip(void) {
+    return lease;
+}
+
+unsigned char* boot_gateway_ip(void) {
+    return lease + 4;
+}
+
+unsigned char* boot_subnet_mask(void) {
+    return lease + 8;
+}
+
+/**
+Function Name : boot_save
+
+Description : Writes the lease in use and the current RTC time to the boot cache, so the start after
+    the restart that follows can be a fast boot. Called from the restart path, after the write-back
+    of the config and the log.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The boot cache is written.
+**/
+void boot_save(void) {
+    unsigned char block[BOOT_BLOCK_SIZE];
+    unsigned long time = rtc_get_date();
+    unsigned char i;
+
+    block[0] = BOOT_TOKEN;
+    for (i = 0; i < BOOT_LEASE_SIZE; i++) {
+        block[1 + i] = lease[i];
+    }
+    block[13] = (unsigned char)time;
+    block[14] = (unsigned char)(time >> 8);
+    block[15] = (unsigned char)(time >> 16);
+    block[16] = (unsigned char)(time >> 24);
+    eeprom_writebuf(BOOT_ADDR, block, BOOT_BLOCK_SIZE);
+}
+
+/**
+Function Name : boot_sync_update
+
+Description : Scheduled every BOOT_SYNC_RETRY_MS after a fast boot. Makes one attempt to synchronize
+    the RTC with network time, a single try of the board library's NTP client with the watchdog
+    reset just before it, and logs EVENT_NEWTIME when it succeeds, which ends the provisional
+    timestamps. After a failed attempt the next 1, 2, 4, ... BOOT_SYNC_BACKOFF_MAX runs are skipped.
+    Does nothing once the clock is synchronized.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    RTC - Set to network time on success.
+    Log - A NEWTIME record is added on success.
+    Boot - The clock is marked synchronized on success; otherwise the back-off grows.
+    Watchdog - Reset before the attempt.
+**/
+void boot_sync_update(void) {
+    if (synced) {
+        return;
+    }
+    if (skip > 0) {
+        skip--;
+        return;
+    }
+    wdt_reset();
+    if (ntp_sync_network_time(1)) {
+        synced = 1;
+        log_add_record(EVENT_NEWTIME);
+        return;
+    }
+    backoff = backoff == 0 ? 1 : backoff * 2;
+    if (backoff > BOOT_SYNC_BACKOFF_MAX) {
+        backoff = BOOT_SYNC_BACKOFF_MAX;
+    }
+    skip = backoff;
+}
@@ -0,0 +1,40 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for boot.c; the fast boot after a requested restart. The DHCP lease and
+    the RTC time are cached in EEPROM before the restart, so the next start can bring the server up
+    with them at once and synchronize with network time in the background.
+**/
+#ifndef BOOT_H_INCLUDED
+#define BOOT_H_INCLUDED
+
+//DEFINES:
+#define BOOT_SYNC_DELAY_MS  1000    //First background NTP attempt after a fast boot, once clients have reconnected
+#define BOOT_SYNC_RETRY_MS  10000   //Period of the background NTP attempts until one succeeds
+#define BOOT_SYNC_BACKOFF_MAX 8     //Most retry periods skipped after a failed attempt
+#define BOOT_NTP_TRY_MS     1000    //Longest one try of the board library's NTP client takes (its reply timeout)
+
+//DECLARATIONS:
+unsigned char boot_restore(void);   //Use up the boot cache; 1 for a fast boot with the cached lease and time
+
+void boot_set_lease(unsigned char* ip, unsigned char* gateway, unsigned char* subnet);    //Keep the lease from DHCP
+
+unsigned char* boot_local_ip(void);     //Address of the lease in use
+
+unsigned char* boot_gateway_ip(void);   //Gateway of the lease in use
+
+unsigned char* boot_subnet_mask(void);  //Subnet mask of the lease in use
+
+void boot_save(void);   //Cache the lease and the time for the start after a requested restart
+
+void boot_sync_update(void);    //Scheduled task after a fast boot: synchronize with network time
+
+#endif
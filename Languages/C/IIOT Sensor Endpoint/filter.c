@@ -0,0 +1,308 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Filter stages between the temperature sensor and the temperature FSM. The FSM used to
+    classify raw readings, so sensor noise around a threshold moved the temperature in and out of a
+    band on consecutive samples, and every entry cost a log record, an EEPROM write-back and an
+    alarm. Each reading now passes through three stages, each of which can be turned off:
+
+        median  The median of the last 1, 3 or 5 readings; removes single-sample spikes.
+        slew    Limits the change of the filtered temperature to 'slew' degrees per sample.
+        ema     Exponential moving average with a smoothing factor of 1 / 2^ema, kept in fixed
+                point with FILTER_EMA_FRACTION fraction bits and updated with a shift. The state
+                is unsigned, offset by FILTER_EMA_OFFSET degrees, so no negative value is shifted.
+
+    The fourth setting, 'hyst', is handed to the FSM (see tempfsm_set_hysteresis): a temperature has
+    to come back past a threshold by that many degrees before it leaves the band it entered, so what
+    noise remains after the filter cannot flap the state across a threshold.
+
+    Everything is integer arithmetic with no multiplication or division. The settings are changed
+    through PUT /device/config, kept in their own EEPROM block at FILTER_ADDR, and written back with
+    the config batch (see writeback.c). A change of settings restarts the filter from the next reading.
+**/
+
+//INCLUDES:
+#include "eeprom.h"
+#include "tempfsm.h"
+#include "filter.h"
+
+//DEFINES:
+#define FILTER_ADDR         0x100   //EEPROM address of the settings block, after the log
+#define FILTER_TOKEN        0x46    //Marks a valid settings block
+#define FILTER_BLOCK_SIZE   5       //token, median, ema, slew, hyst
+#define FILTER_EMA_FRACTION 4       //Fraction bits of the EMA state
+#define FILTER_EMA_OFFSET   2048    //Offset of the EMA state; -2048 to 2047 degrees fit an unsigned int
+
+//DECLARATIONS:
+static filterSettings settings;
+static unsigned char settingsDirty;     //settings differ from the EEPROM block
+
+static int window[FILTER_MEDIAN_MAX];   //Last readings, oldest first
+static unsigned char windowLen;
+static int slewed;                      //Output of the slew stage
+static unsigned int average;            //EMA state, offset by FILTER_EMA_OFFSET, with FILTER_EMA_FRACTION fraction bits
+static unsigned char primed;            //A reading has been filtered since the last restart
+
+/**
+Function Name : filter_init
+
+Description : Loads the settings from their EEPROM block. Without a valid block every stage is off,
+    so the FSM sees the raw readings as it did before the filter stages existed.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Filter - The settings are loaded and the filter restarted.
+    Temp FSM - The hysteresis is set.
+**/
+void filter_init(void) {
+    unsigned char block[FILTER_BLOCK_SIZE];
+
+    eeprom_readbuf(FILTER_ADDR, block, FILTER_BLOCK_SIZE);
+    settings.median = block[1];
+    settings.ema = block[2];
+    settings.slew = block[3];
+    settings.hyst = block[4];
+    if (block[0] != FILTER_TOKEN || filter_check(&settings)) {
+        settings.median = 1;
+        settings.ema = 0;
+        settings.slew = 0;
+        settings.hyst = 0;
+    }
+    settingsDirty = 0;
+    primed = 0;
+    tempfsm_set_hysteresis(settings.hyst);
+}
+
+/**
+Function Name : filter_get
+
+Description : Copies the current settings.
+
+Arguments :
+    (filterSettings*) out - Receives the settings.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void filter_get(filterSettings* out) {
+    *out = settings;
+}
+
+/**
+Function Name : filter_check
+
+Description : Checks settings against the ranges the stages support.
+
+Arguments :
+    (filterSettings*) proposed - The settings to check.
+
+Returns :
+    (unsigned char) - 0 if every setting is in range, otherwise 1.
+
+Changes :
+    N/A
+**/
+unsigned char filter_check(filterSettings* proposed) {
+    return proposed->median == 0 || proposed->median > FILTER_MEDIAN_MAX || (proposed->median & 1) == 0 ||
+           proposed->ema > FILTER_EMA_MAX || proposed->slew > FILTER_SLEW_MAX || proposed->hyst > FILTER_HYST_MAX;
+}
+
+/**
+Function Name : filter_set
+
+Description : Applies settings that have passed filter_check. The filter restarts from the next
+    reading, so no stage mixes readings filtered under different settings.
+
+Arguments :
+    (filterSettings*) proposed - The new settings.
+
+Returns :
+    (unsigned char) - 1 if the settings changed, otherwise 0.
+
+Changes :
+    Filter - The settings are replaced and the filter restarted if they changed.
+    Temp FSM - The hysteresis is set.
+**/
+unsigned char filter_set(filterSettings* proposed) {
+    if (proposed->median == settings.median && proposed->ema == settings.ema &&
+            proposed->slew == settings.slew && proposed->hyst == settings.hyst) {
+        return 0;
+    }
+    settings = *proposed;
+    settingsDirty = 1;
+    primed = 0;
+    tempfsm_set_hysteresis(settings.hyst);
+    return 1;
+}
+
+/**
+Function Name : filter_update
+
+Description : Writes the settings block back to EEPROM if the settings changed since it was written.
+    Called from the write-back task with the config batch.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The settings block is written.
+**/
+void filter_update(void) {
+    unsigned char block[FILTER_BLOCK_SIZE];
+
+    if (!settingsDirty) {
+        return;
+    }
+    block[0] = FILTER_TOKEN;
+    block[1] = settings.median;
+    block[2] = settings.ema;
+    block[3] = settings.slew;
+    block[4] = settings.hyst;
+    eeprom_writebuf(FILTER_ADDR, block, FILTER_BLOCK_SIZE);
+    settingsDirty = 0;
+}
+
+/**
+Function Name : median
+
+Description : Adds a reading to the median window and returns the median of the window. Until the
+    window has filled after a restart, the median of the readings so far (the upper one of an even
+    count) is returned. The window holds at most FILTER_MEDIAN_MAX readings, so an insertion sort of
+    a copy is the cheapest way to find it.
+
+Arguments :
+    (int) reading - The new reading.
+
+Returns :
+    (int) - The median.
+
+Changes :
+    Filter - The reading is added to the window, dropping the oldest once it is full.
+**/
+static int median(int reading) {
+    int sorted[FILTER_MEDIAN_MAX];
+    unsigned char i;
+    unsigned char j;
+
+    if (windowLen == settings.median) {
+        for (i = 1; i < windowLen; i++) {
+            window[i - 1] = window[i];
+        }
+        windowLen--;
+    }
+    window[windowLen++] = reading;
+
+    for (i = 0; i < windowLen; i++) {
+        for (j = i; j > 0 && sorted[j - 1] > window[i]; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = window[i];
+    }
+    return sorted[windowLen >> 1];
+}
+
+/**
+Function Name : emaState
+
+Description : Converts a temperature to the unsigned fixed point form of the EMA state. Temperatures
+    outside the range the state can hold are clamped to it.
+
+Arguments :
+    (int) value - The temperature, in whole degrees.
+
+Returns :
+    (unsigned int) - The temperature plus FILTER_EMA_OFFSET, with FILTER_EMA_FRACTION fraction bits.
+
+Changes :
+    N/A
+**/
+static unsigned int emaState(int value) {
+    if (value < -FILTER_EMA_OFFSET) {
+        value = -FILTER_EMA_OFFSET;
+    } else if (value > FILTER_EMA_OFFSET - 1) {
+        value = FILTER_EMA_OFFSET - 1;
+    }
+    return (unsigned int)(value + FILTER_EMA_OFFSET) << FILTER_EMA_FRACTION;
+}
+
+/**
+Function Name : filter_apply
+
+Description : Runs a sensor reading through the median, slew and EMA stages. The first reading after
+    a restart starts the slew and EMA stages at its median, so the output does not ramp up from 0.
+    The EMA moves its state by the difference to the new value divided by 2^ema, rounded to nearest
+    with an added half so the state settles on a constant input instead of stopping short of it.
+    A step down is rounded the same way, as the ceiling of the step less the half, so the EMA
+    behaves the same in both directions without shifting a negative value.
+
+Arguments :
+    (int) reading - The temperature reading from the sensor.
+
+Returns :
+    (int) - The filtered temperature, in whole degrees.
+
+Changes :
+    Filter - The state of every stage is updated.
+**/
+int filter_apply(int reading) {
+    int value;
+    unsigned int target;
+    unsigned int step;
+    unsigned int half;
+
+    if (!primed) {
+        windowLen = 0;
+        value = median(reading);
+        slewed = value;
+        average = emaState(value);
+        primed = 1;
+        return value;
+    }
+
+    value = median(reading);
+
+    if (settings.slew != 0) {
+        if (value > slewed + settings.slew) {
+            value = slewed + settings.slew;
+        } else if (value < slewed - settings.slew) {
+            value = slewed - settings.slew;
+        }
+    }
+    slewed = value;
+
+    if (settings.ema != 0) {
+        target = emaState(value);
+        half = 1U << (settings.ema - 1);
+        if (target >= average) {
+            average += (target - average + half) >> settings.ema;
+        } else {
+            step = average - target;
+            if (step > half) {
+                average -= (step - half + (1U << settings.ema) - 1) >> settings.ema;
+            }
+        }
+        value = (int)((average + (1U << (FILTER_EMA_FRACTION - 1))) >> FILTER_EMA_FRACTION) - FILTER_EMA_OFFSET;
+    } else {
+        average = emaState(value);
+    }
+    return value;
+}
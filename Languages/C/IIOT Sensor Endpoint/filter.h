@@ -0,0 +1,46 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for filter.c; the integer filter stages between the temperature sensor and
+    the temperature FSM, and their settings, which are set through PUT /device/config and kept in
+    EEPROM.
+**/
+#ifndef FILTER_H_INCLUDED
+#define FILTER_H_INCLUDED
+
+//DEFINES:
+#define FILTER_MEDIAN_MAX   5       //Longest median window; the window is 1 (off), 3 or 5 samples
+#define FILTER_EMA_MAX      4       //Largest EMA shift; the smoothing factor is 1 / 2^shift
+#define FILTER_SLEW_MAX     100     //Largest rate limit, degrees per sample
+#define FILTER_HYST_MAX     10      //Largest alarm hysteresis, degrees
+
+//DECLARATIONS:
+//Filter settings; every stage is off at 0 (1 for the median window)
+typedef struct {
+    unsigned char median;   //Median window, in samples
+    unsigned char ema;      //EMA shift
+    unsigned char slew;     //Largest change of the filtered temperature per sample
+    unsigned char hyst;     //Degrees a reading must come back past a threshold to leave its band
+} filterSettings;
+
+void filter_init(void);     //Load the settings from EEPROM, or turn every stage off
+
+void filter_get(filterSettings* settings);  //Copy the current settings
+
+unsigned char filter_check(filterSettings* settings);   //0 if the settings are in range, otherwise 1
+
+unsigned char filter_set(filterSettings* settings);    //Apply checked settings and restart the filter; 1 if they changed
+
+void filter_update(void);   //Write changed settings back to EEPROM
+
+int filter_apply(int reading);  //Run a sensor reading through the filter stages
+
+#endif
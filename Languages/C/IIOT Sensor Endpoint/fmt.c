@@ -0,0 +1,332 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Integer-only text formatters. The AVR has no divide instruction, so every '/' or '%'
+    on a long is a call into the 32-bit division routine (several hundred cycles), and the library
+    formatters divide once or twice per digit and walk the calendar from 1970 for every date.
+
+    fmt_dec finds each digit by subtracting powers of ten from a table, using 16-bit arithmetic once
+    the value fits. The tables are kept in flash, as the AVR would otherwise copy them into SRAM.
+    fmt_date remembers the calendar day of the previous call: a timestamp on the same day needs no
+    calendar work at all, one a few days later is stepped forward day by day, and only a jump
+    backwards or of more than FMT_DATE_STEP_MAX days falls back to a full conversion. Log records
+    are formatted oldest first, so after the first record nearly every date is incremental. The
+    output is character for character that of socket_writedec32, rtc_num2datestr and
+    socket_write_macaddress (checked by sim/fmtbench.c).
+**/
+
+//INCLUDES:
+#include "progmem.h"
+#include "fmt.h"
+
+//DEFINES:
+#define SECONDS_PER_DAY     86400UL
+#define DAYS_PER_4_YEARS    1461        /* four years including one leap year */
+#define FMT_DATE_STEP_MAX   31          /* days stepped forward before a full conversion is cheaper */
+
+//DECLARATIONS:
+static const unsigned long pow10Long[] PROGMEM = {1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL};
+static const unsigned int pow10Int[] PROGMEM = {10000, 1000, 100, 10};
+static const unsigned char monthDays[12] PROGMEM = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+static const char hexDigits[] PROGMEM = "0123456789ABCDEF";
+
+//Calendar day of the previous fmt_date call
+static unsigned char dateValid;
+static unsigned long dayStart;      //Seconds at 00:00:00 of the day
+static unsigned int year;
+static unsigned char month;         //0 for January
+static unsigned char day;           //0 for the first of the month
+
+/**
+Function Name : fmt_dec
+
+Description : Writes a signed decimal number with no padding. Each digit is counted out by
+    subtracting its power of ten, at most nine times, instead of by division.
+
+Arguments :
+    (char*) out - Receives the digits; must have room for FMT_DEC_MAX characters. Not terminated.
+    (long) value - The number to write.
+
+Returns :
+    (unsigned char) - The number of characters written.
+
+Changes :
+    N/A
+**/
+unsigned char fmt_dec(char* out, long value) {
+    unsigned long magnitude;
+    unsigned long power;
+    unsigned int small;
+    unsigned int smallPower;
+    unsigned char n = 0;
+    unsigned char i;
+    char digit;
+
+    if (value < 0) {
+        out[n++] = '-';
+        magnitude = 0UL - (unsigned long)value;
+    } else {
+        magnitude = (unsigned long)value;
+    }
+
+    //Digits above the 16-bit range, skipping leading zeros
+    i = 0;
+    if (magnitude >= pgm_read_dword(&pow10Long[sizeof(pow10Long) / sizeof(pow10Long[0]) - 1])) {
+        while (magnitude < pgm_read_dword(&pow10Long[i])) {
+            i++;
+        }
+        for (; i < sizeof(pow10Long) / sizeof(pow10Long[0]); i++) {
+            power = pgm_read_dword(&pow10Long[i]);
+            digit = '0';
+            while (magnitude >= power) {
+                magnitude -= power;
+                digit++;
+            }
+            out[n++] = digit;
+        }
+        i = 0;
+    } else {
+        while (i < sizeof(pow10Int) / sizeof(pow10Int[0]) && magnitude < pgm_read_word(&pow10Int[i])) {
+            i++;
+        }
+    }
+
+    //The rest fits in 16 bits
+    small = (unsigned int)magnitude;
+    for (; i < sizeof(pow10Int) / sizeof(pow10Int[0]); i++) {
+        smallPower = pgm_read_word(&pow10Int[i]);
+        digit = '0';
+        while (small >= smallPower) {
+            small -= smallPower;
+            digit++;
+        }
+        out[n++] = digit;
+    }
+    out[n++] = (char)('0' + small);
+    return n;
+}
+
+/**
+Function Name : isLeap
+
+Description : Leap year test for the years an unsigned long of seconds since 1970 can reach, where
+    2100 is the only year divisible by four that is not a leap year.
+
+Arguments :
+    (unsigned int) y - The year.
+
+Returns :
+    (unsigned char) - 1 for a leap year, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char isLeap(unsigned int y) {
+    return (y & 3) == 0 && y != 2100;
+}
+
+/**
+Function Name : monthLength
+
+Description : Number of days in the current month of the remembered date.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - The number of days.
+
+Changes :
+    N/A
+**/
+static unsigned char monthLength(void) {
+    if (month == 1 && isLeap(year)) {
+        return 29;
+    }
+    return pgm_read_byte(&monthDays[month]);
+}
+
+/**
+Function Name : setDay
+
+Description : Full conversion of a day count since 01/01/1970 to a calendar date, stepping four
+    years at a time while that cannot cross 2100 (not a leap year), then a year and a month at a time.
+
+Arguments :
+    (unsigned long) seconds - Any time on the day to convert.
+
+Returns :
+    void
+
+Changes :
+    fmt_date - The remembered day is replaced.
+**/
+static void setDay(unsigned long seconds) {
+    unsigned int days = (unsigned int)(seconds / SECONDS_PER_DAY);
+    unsigned int yearLength;
+
+    dayStart = (unsigned long)days * SECONDS_PER_DAY;
+    year = 1970;
+    while (days >= DAYS_PER_4_YEARS && year + 4 <= 2098) {
+        days -= DAYS_PER_4_YEARS;
+        year += 4;
+    }
+    for (;;) {
+        yearLength = isLeap(year) ? 366 : 365;
+        if (days < yearLength) {
+            break;
+        }
+        days -= yearLength;
+        year++;
+    }
+    month = 0;
+    while (days >= monthLength()) {
+        days -= monthLength();
+        month++;
+    }
+    day = (unsigned char)days;
+    dateValid = 1;
+}
+
+/**
+Function Name : putTwo
+
+Description : Writes a number below 100 as two digits.
+
+Arguments :
+    (char*) out - Receives the two digits.
+    (unsigned char) value - The number to write.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void putTwo(char* out, unsigned char value) {
+    char tens = '0';
+    while (value >= 10) {
+        value -= 10;
+        tens++;
+    }
+    out[0] = tens;
+    out[1] = (char)('0' + value);
+}
+
+/**
+Function Name : fmt_date
+
+Description : Writes a time as "MM/DD/YYYY HH:MM:SS", the format of rtc_num2datestr. The calendar
+    day is reused from the previous call when possible (see the description at the top of the file).
+
+Arguments :
+    (char*) out - Receives FMT_DATE_LEN characters. Not terminated.
+    (unsigned long) seconds - Seconds since 01/01/1970 00:00:00.
+
+Returns :
+    void
+
+Changes :
+    fmt_date - The remembered day is moved to the day of 'seconds'.
+**/
+void fmt_date(char* out, unsigned long seconds) {
+    unsigned long timeOfDay;
+    unsigned int rest;
+    unsigned char steps = 0;
+    unsigned char hours = 0;
+    unsigned char minutes = 0;
+    unsigned char century = 19;
+    unsigned char yearOfCentury;
+
+    //Find the calendar day, stepping forward from the remembered one when it is close
+    if (!dateValid || seconds < dayStart) {
+        setDay(seconds);
+    }
+    while (seconds - dayStart >= SECONDS_PER_DAY) {
+        if (++steps > FMT_DATE_STEP_MAX) {
+            setDay(seconds);
+            break;
+        }
+        dayStart += SECONDS_PER_DAY;
+        if (++day == monthLength()) {
+            day = 0;
+            if (++month == 12) {
+                month = 0;
+                year++;
+            }
+        }
+    }
+
+    //Split the time of day
+    timeOfDay = seconds - dayStart;
+    while (timeOfDay >= 36000UL) {
+        timeOfDay -= 36000UL;
+        hours += 10;
+    }
+    rest = (unsigned int)timeOfDay;
+    while (rest >= 3600) {
+        rest -= 3600;
+        hours++;
+    }
+    while (rest >= 600) {
+        rest -= 600;
+        minutes += 10;
+    }
+    while (rest >= 60) {
+        rest -= 60;
+        minutes++;
+    }
+    yearOfCentury = (unsigned char)(year - 1900);
+    while (yearOfCentury >= 100) {
+        yearOfCentury -= 100;
+        century++;
+    }
+
+    putTwo(out, month + 1);
+    out[2] = '/';
+    putTwo(out + 3, day + 1);
+    out[5] = '/';
+    putTwo(out + 6, century);
+    putTwo(out + 8, yearOfCentury);
+    out[10] = ' ';
+    putTwo(out + 11, hours);
+    out[13] = ':';
+    putTwo(out + 14, minutes);
+    out[16] = ':';
+    putTwo(out + 17, (unsigned char)rest);
+}
+
+/**
+Function Name : fmt_mac
+
+Description : Writes a MAC address as six upper case hex pairs separated by ':'.
+
+Arguments :
+    (char*) out - Receives FMT_MAC_LEN characters. Not terminated.
+    (unsigned char*) mac - The six bytes of the MAC address.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void fmt_mac(char* out, unsigned char* mac) {
+    unsigned char i;
+
+    for (i = 0; i < 6; i++) {
+        if (i != 0) {
+            *out++ = ':';
+        }
+        *out++ = pgm_read_byte(&hexDigits[mac[i] >> 4]);
+        *out++ = pgm_read_byte(&hexDigits[mac[i] & 0x0F]);
+    }
+}
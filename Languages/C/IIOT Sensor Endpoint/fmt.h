@@ -0,0 +1,30 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for fmt.c; integer-only text formatters for decimal numbers, RTC dates and
+    MAC addresses that produce the same text as the socket and RTC libraries without dividing.
+**/
+#ifndef FMT_H_INCLUDED
+#define FMT_H_INCLUDED
+
+//DEFINES:
+#define FMT_DEC_MAX     11      /* "-2147483648" */
+#define FMT_DATE_LEN    19      /* "MM/DD/YYYY HH:MM:SS" */
+#define FMT_MAC_LEN     17      /* "XX:XX:XX:XX:XX:XX" */
+
+//DECLARATIONS:
+unsigned char fmt_dec(char* out, long value);   //Signed decimal, no padding; returns the length
+
+void fmt_date(char* out, unsigned long seconds);    //Date and time in the rtc_num2datestr format
+
+void fmt_mac(char* out, unsigned char* mac);    //MAC address as upper case hex pairs
+
+#endif
@@ -0,0 +1,744 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : EEPROM event log. Replaces the board support library's log module with the same
+    interface. New records are held in RAM and written back by log_update from the cyclic executive,
+    so log_add_record is safe to call from anywhere.
+
+    Every record gets a sequence number one higher than the record before it. The sequence of the
+    oldest record is kept with the log, in RAM and in EEPROM, and advances when records are dropped
+    or cleared, so a client can ask for the records added after the last one it has seen (see
+    GET /device/log?since= in parser.c) and tell when records it never saw were dropped.
+
+    The records are stored compactly. A full record used to take 9 bytes (time, event and sequence
+    number), so the log area held 16 of them. The area is now split into LOG_BLOCKS blocks, used in
+    turn. A block starts with the sequence number of its first record, and its records follow with
+    no sequence number of their own. The first record of a block is a base record, holding the full
+    time. Each record after it holds only the seconds since the record before, in 0, 1 or 2 bytes
+    after a head byte that packs the event code into 3 bits:
+
+        head    event - 1 (3 bits), length (2 bits), low 3 bits of the delta
+        length  0: delta < 8 s, 1 byte; 1: delta < 2048 s, 2 bytes; 2: delta < 6 days, 3 bytes;
+                3: base record, the full time in 4 more bytes, for the first record of a block and
+                   for a time that went backwards or jumped (NTP) too far for a delta
+
+    A head byte with an event field of 7 ends the block's records, and an erased byte reads as one.
+    Records minutes apart take 2 bytes and records seconds apart 1, so a block holds 15 to 30 of
+    them, and the area, three to four blocks' worth, 45 to 120 instead of 16. When a new block is
+    needed, the oldest block is taken over and its records are dropped together. Reading a record
+    decodes forward from the base record of its block; a cursor remembers where the last read
+    stopped, so reading the log in order decodes each record once. The RAM index is the first
+    sequence number and record count of each block.
+
+    Wear stays levelled: blocks are taken in turn, and a record is written once, with the head byte
+    last, after the byte that follows it has been made an end mark. A write cut short leaves the block
+    ending before the record. Opening a block ends its old records before its sequence number is
+    replaced, and log_init ignores a block without a base record. log_init finds the block with the
+    highest sequence number and walks back over the blocks whose records run on into it. The header
+    only holds the sequence number below which records were cleared and is written by log_clear alone.
+
+    A record is provisional when it was stamped before the clock was synchronized: after a TIMESET
+    record (the RTC set at start-up, or restored by a fast boot, see boot.c) and before the NEWTIME
+    record that follows it. Nothing is stored for this; the head byte has no bit to spare, and the
+    state follows from the records before. The RAM index keeps the state at the start of each block,
+    and log_get_record carries it forward as it decodes, so log_get_provisional costs nothing.
+**/
+
+//INCLUDES:
+#include "eeprom.h"
+#include "rtc.h"
+#include "strbuf.h"
+#include "stats.h"
+#include "log.h"
+
+//DEFINES:
+#define LOG_ADDR        0x060   //EEPROM address of the log header
+#define LOG_TOKEN       0x4E    //Marks a valid log header in this layout
+#define LOG_HEADER_SIZE 6       //token, spare, sequence number records were cleared below
+#define LOG_BLOCKS_ADDR (LOG_ADDR + 8)  //EEPROM address of block 0; the blocks end at 0x100
+#define LOG_BLOCKS      4       //Blocks in the record area
+#define LOG_BLOCK_SIZE  38      //Sequence number of the first record (4), then the records
+#define LOG_DATA_SIZE   (LOG_BLOCK_SIZE - 4)    //Record bytes in a block
+#define LOG_BASE_SIZE   5       //Size of a base record: head, time (4)
+#define LOG_BASE_LENGTH 3       //Length field of a base record
+#define LOG_DELTA_MAX   0x7FFFFUL   //Largest delta a record can hold, 19 bits
+#define LOG_END_MASK    0xE0    //Event field of a head byte; all ones ends the records of a block
+#define LOG_ERASED      0xFF    //End mark written by the log; the value of an erased byte
+#define LOG_EVENT_MAX   7       //Highest event code the head byte can hold
+#define LOG_PENDING     4       //Records held for write back; a full queue is written back at once
+
+//DECLARATIONS:
+static unsigned long blockSeq[LOG_BLOCKS];      //Sequence number of each block's first record
+static unsigned char blockCount[LOG_BLOCKS];    //Records in each block, written back or not; 0 if unused
+static unsigned char appendBlock;               //Block holding the newest record
+static unsigned char appendUsed;                //Record bytes used in appendBlock, written back or not
+static unsigned long appendTime;                //Time of the newest record
+static unsigned char blockProvisional[LOG_BLOCKS];  //The clock was unsynchronized before each block's first record
+static unsigned char appendProvisional;         //The clock was unsynchronized at the newest record
+static unsigned char logCount;
+static unsigned long logFirstSeq;   //Sequence number of the oldest record
+static unsigned long logClearSeq;   //Records below this sequence number were cleared
+static unsigned char logHeaderDirty;
+
+static unsigned long pendingTime[LOG_PENDING];  //Records not yet written back, oldest first
+static unsigned char pendingEvent[LOG_PENDING];
+static unsigned char pendingLen;
+static unsigned char pendingProvisional;    //The clock was unsynchronized before the oldest pending record
+static unsigned char writeBlock;    //Block the last record written back is in
+static unsigned int writeAddr;      //EEPROM address after the last record written back
+static unsigned long writeTime;     //Time of the last record written back
+
+static unsigned char cursorValid;   //The cursor points into a block in use
+static unsigned char cursorBlock;
+static unsigned long cursorSeq;     //Sequence number of the record at cursorAddr
+static unsigned int cursorAddr;
+static unsigned long cursorTime;    //Time of the record before cursorAddr
+static unsigned char cursorProvisional; //The clock was unsynchronized at the record before cursorAddr
+static unsigned char readProvisional;   //The record last read by log_get_record is provisional
+
+static void writeChanged(unsigned int addr, unsigned char* buf, unsigned char size);    //Write only differing bytes
+static unsigned long getLong(unsigned char* buf);   //Little endian 32-bit field
+static void putLong(unsigned char* buf, unsigned long value);
+
+/**
+Function Name : clockState
+
+Description : Returns whether the clock is unsynchronized after a record, given the state before it.
+    A TIMESET record starts a provisional run and a NEWTIME record ends it.
+
+Arguments :
+    (unsigned char) provisional - 1 if the clock was unsynchronized before the record.
+    (unsigned char) eventnum - The EVENT_ code of the record.
+
+Returns :
+    (unsigned char) - 1 if the record, and those after it, are provisional.
+
+Changes :
+    N/A
+**/
+static unsigned char clockState(unsigned char provisional, unsigned char eventnum) {
+    if (eventnum == EVENT_TIMESET) {
+        return 1;
+    }
+    if (eventnum == EVENT_NEWTIME) {
+        return 0;
+    }
+    return provisional;
+}
+
+/**
+Function Name : dataAddr
+
+Description : Returns the EEPROM address of the first record byte of a block.
+
+Arguments :
+    (unsigned char) block - The block.
+
+Returns :
+    (unsigned int) - The address, just after the block's sequence number.
+
+Changes :
+    N/A
+**/
+static unsigned int dataAddr(unsigned char block) {
+    return LOG_BLOCKS_ADDR + block * LOG_BLOCK_SIZE + 4;
+}
+
+/**
+Function Name : endRecords
+
+Description : Makes the byte at an address an end mark, unless it already reads as one.
+
+Arguments :
+    (unsigned int) addr - EEPROM address of the byte.
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The byte is written if it did not end the records.
+**/
+static void endRecords(unsigned int addr) {
+    unsigned char head;
+
+    eeprom_readbuf(addr, &head, 1);
+    if ((head & LOG_END_MASK) != LOG_END_MASK) {
+        head = LOG_ERASED;
+        eeprom_writebuf(addr, &head, 1);
+    }
+}
+
+/**
+Function Name : recordSize
+
+Description : Returns the size of a record that is not the first of its block.
+
+Arguments :
+    (unsigned long) time - The time of the record.
+    (unsigned long) prev - The time of the record before it.
+
+Returns :
+    (unsigned char) - 1 to 3 bytes for a delta, LOG_BASE_SIZE for a base record.
+
+Changes :
+    N/A
+**/
+static unsigned char recordSize(unsigned long time, unsigned long prev) {
+    if (time < prev || time - prev > LOG_DELTA_MAX) {
+        return LOG_BASE_SIZE;
+    }
+    return time - prev < 0x8 ? 1 : time - prev < 0x800 ? 2 : 3;
+}
+
+/**
+Function Name : encodeRecord
+
+Description : Encodes a record, as a base record or as a delta from the record before it.
+
+Arguments :
+    (unsigned char*) buf - Receives the record; LOG_BASE_SIZE bytes long.
+    (unsigned long) time - The time of the record.
+    (unsigned long) prev - The time of the record before it.
+    (unsigned char) eventnum - The EVENT_ code, 1 to LOG_EVENT_MAX.
+    (unsigned char) base - 1 for the first record of a block, which is always a base record.
+
+Returns :
+    (unsigned char) - The size of the record.
+
+Changes :
+    N/A
+**/
+static unsigned char encodeRecord(unsigned char* buf, unsigned long time, unsigned long prev,
+                                  unsigned char eventnum, unsigned char base) {
+    unsigned char size = base ? LOG_BASE_SIZE : recordSize(time, prev);
+    unsigned long delta = time - prev;
+
+    buf[0] = (unsigned char)((eventnum - 1) << 5);
+    if (size == LOG_BASE_SIZE) {
+        buf[0] |= LOG_BASE_LENGTH << 3;
+        putLong(buf + 1, time);
+    } else {
+        buf[0] |= (unsigned char)(((size - 1) << 3) | (delta & 0x7));
+        buf[1] = (unsigned char)(delta >> 3);
+        buf[2] = (unsigned char)(delta >> 11);
+    }
+    return size;
+}
+
+/**
+Function Name : decodeRecord
+
+Description : Decodes the record at an address.
+
+Arguments :
+    (unsigned int) addr - EEPROM address of the record's head byte.
+    (unsigned char) avail - Record bytes left in the block from 'addr'.
+    (unsigned long) prev - The time of the record before it.
+    (unsigned long*) time - Receives the time of the record.
+    (unsigned char*) eventnum - Receives the EVENT_ code of the record.
+
+Returns :
+    (unsigned char) - The size of the record, or 0 at the end of the block's records.
+
+Changes :
+    N/A
+**/
+static unsigned char decodeRecord(unsigned int addr, unsigned char avail, unsigned long prev,
+                                  unsigned long* time, unsigned char* eventnum) {
+    unsigned char buf[LOG_BASE_SIZE];
+    unsigned char size;
+
+    if (avail == 0) {
+        return 0;
+    }
+    eeprom_readbuf(addr, buf, 1);
+    if ((buf[0] & LOG_END_MASK) == LOG_END_MASK) {
+        return 0;
+    }
+    size = ((buf[0] >> 3) & 0x3) == LOG_BASE_LENGTH ? LOG_BASE_SIZE : ((buf[0] >> 3) & 0x3) + 1;
+    if (size > avail) {
+        return 0;
+    }
+    eeprom_readbuf(addr + 1, buf + 1, size - 1);
+
+    *eventnum = (buf[0] >> 5) + 1;
+    if (size == LOG_BASE_SIZE) {
+        *time = getLong(buf + 1);
+    } else {
+        *time = prev + (buf[0] & 0x7);
+        if (size > 1) {
+            *time += (unsigned long)buf[1] << 3;
+        }
+        if (size > 2) {
+            *time += (unsigned long)buf[2] << 11;
+        }
+    }
+    return size;
+}
+
+/**
+Function Name : log_init
+
+Description : Loads the index of the log from EEPROM. Each block's records are decoded to count them.
+    The newest block is the one in use with the highest sequence number, and the log is the run of
+    blocks before it whose records lead on to it, less the records below the cleared mark. An EEPROM
+    without a valid log header in this layout is given an empty log starting at sequence number 0.
+    The clock is taken to be synchronized before the oldest block, whose earlier records are gone.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Log - The index of the log is loaded from EEPROM.
+    EEPROM - The log area is emptied if it holds no log.
+**/
+void log_init(void) {
+    unsigned char header[LOG_HEADER_SIZE];
+    unsigned char used[LOG_BLOCKS];
+    unsigned long last[LOG_BLOCKS];
+    unsigned char mark[LOG_BLOCKS];
+    unsigned long time = 0;
+    unsigned long end;
+    unsigned char event;
+    unsigned char size;
+    unsigned char found = 0;
+    unsigned char provisional = 0;
+    unsigned char oldest;
+    unsigned char block;
+    unsigned char i;
+
+    logHeaderDirty = 0;
+    pendingLen = 0;
+    cursorValid = 0;
+    appendProvisional = 0;
+
+    eeprom_readbuf(LOG_ADDR, header, LOG_HEADER_SIZE);
+    if (header[0] != LOG_TOKEN) {
+        //No log in this layout; end the records of every block and start empty
+        header[0] = LOG_TOKEN;
+        header[1] = 0;
+        putLong(header + 2, 0);
+        eeprom_writebuf(LOG_ADDR, header, LOG_HEADER_SIZE);
+        for (i = 0; i < LOG_BLOCKS; i++) {
+            endRecords(dataAddr(i));
+        }
+    }
+    logClearSeq = getLong(header + 2);
+
+    //Count the records of every block and find the newest block
+    for (i = 0; i < LOG_BLOCKS; i++) {
+        eeprom_readbuf(dataAddr(i) - 4, header, 4);
+        blockSeq[i] = getLong(header);
+        blockCount[i] = 0;
+        used[i] = 0;
+        mark[i] = 0;
+        while ((size = decodeRecord(dataAddr(i) + used[i], LOG_DATA_SIZE - used[i], time, &time, &event)) != 0 &&
+                (used[i] != 0 || size == LOG_BASE_SIZE)) {
+            used[i] += size;
+            blockCount[i]++;
+            if (event == EVENT_TIMESET || event == EVENT_NEWTIME) {
+                mark[i] = event;
+            }
+        }
+        last[i] = time;
+        if (blockCount[i] != 0 && (!found || blockSeq[i] > blockSeq[appendBlock])) {
+            appendBlock = i;
+            found = 1;
+        }
+    }
+    if (!found) {
+        //No records; the first record opens block 0
+        appendBlock = LOG_BLOCKS - 1;
+        appendUsed = LOG_DATA_SIZE;
+        logFirstSeq = logClearSeq;
+        logCount = 0;
+        writeBlock = appendBlock;
+        return;
+    }
+    appendUsed = used[appendBlock];
+    appendTime = last[appendBlock];
+    writeBlock = appendBlock;
+    writeAddr = dataAddr(appendBlock) + appendUsed;
+    writeTime = appendTime;
+
+    //Walk back over the blocks whose records run on into the next; the rest hold no records of the log
+    oldest = appendBlock;
+    for (i = 1; i < LOG_BLOCKS; i++) {
+        block = (oldest + LOG_BLOCKS - 1) % LOG_BLOCKS;
+        if (blockCount[block] == 0 || blockSeq[block] + blockCount[block] != blockSeq[oldest]) {
+            break;
+        }
+        oldest = block;
+    }
+    for (; i < LOG_BLOCKS; i++) {
+        blockCount[(appendBlock + LOG_BLOCKS - i) % LOG_BLOCKS] = 0;
+    }
+
+    //Follow the clock state forward from the oldest block; each block's last TIMESET or NEWTIME sets it
+    for (block = oldest; ; block = (block + 1) % LOG_BLOCKS) {
+        blockProvisional[block] = provisional;
+        if (mark[block] != 0) {
+            provisional = clockState(provisional, mark[block]);
+        }
+        if (block == appendBlock) {
+            break;
+        }
+    }
+    appendProvisional = provisional;
+
+    end = blockSeq[appendBlock] + blockCount[appendBlock];
+    logFirstSeq = blockSeq[oldest] > logClearSeq ? blockSeq[oldest] : logClearSeq;
+    if (logFirstSeq > end) {
+        logFirstSeq = end;
+    }
+    logCount = (unsigned char)(end - logFirstSeq);
+}
+
+/**
+Function Name : log_clear
+
+Description : Removes every record. The sequence numbers of the removed records are not reused, and
+    the records are left in EEPROM below the cleared mark instead of being erased. Records not yet
+    written back are still written, below the mark, so the blocks stay as the index describes them.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Log - The log is emptied and its header marked for write back.
+**/
+void log_clear(void) {
+    logFirstSeq += logCount;
+    logClearSeq = logFirstSeq;
+    logCount = 0;
+    logHeaderDirty = 1;
+}
+
+/**
+Function Name : log_add_record
+
+Description : Appends a record for 'eventnum' stamped with the current RTC time. The record goes in
+    the newest block if it fits; otherwise the next block is taken over, and its records, the oldest
+    in the log, are dropped. The record is written back by log_update, or at once if LOG_PENDING
+    records are already waiting.
+
+Arguments :
+    (unsigned char) eventnum - The EVENT_ code to record, 1 to LOG_EVENT_MAX; other codes are ignored.
+
+Returns :
+    void
+
+Changes :
+    Log - A record is added and queued for write back.
+**/
+void log_add_record(unsigned char eventnum) {
+    unsigned long time = rtc_get_date();
+    unsigned long seq;
+    unsigned long end;
+    unsigned char size;
+
+    if (eventnum == 0 || eventnum > LOG_EVENT_MAX) {
+        return;
+    }
+    if (pendingLen == LOG_PENDING) {
+        log_update();
+    }
+    if (pendingLen == 0) {
+        pendingProvisional = appendProvisional;
+    }
+
+    seq = logFirstSeq + logCount;
+    size = recordSize(time, appendTime);
+    if (blockCount[appendBlock] == 0 || blockSeq[appendBlock] + blockCount[appendBlock] != seq ||
+            appendUsed + size > LOG_DATA_SIZE) {
+        appendBlock = (appendBlock + 1) % LOG_BLOCKS;
+        end = blockSeq[appendBlock] + blockCount[appendBlock];
+        if (blockCount[appendBlock] != 0 && end > logFirstSeq) {
+            logCount -= (unsigned char)(end - logFirstSeq);
+            logFirstSeq = end;
+        }
+        if (cursorBlock == appendBlock) {
+            cursorValid = 0;
+        }
+        blockSeq[appendBlock] = seq;
+        blockCount[appendBlock] = 0;
+        blockProvisional[appendBlock] = appendProvisional;
+        appendUsed = 0;
+        size = LOG_BASE_SIZE;
+    }
+    blockCount[appendBlock]++;
+    appendUsed += size;
+    appendTime = time;
+    appendProvisional = clockState(appendProvisional, eventnum);
+
+    pendingTime[pendingLen] = time;
+    pendingEvent[pendingLen] = eventnum;
+    pendingLen++;
+    logCount++;
+}
+
+/**
+Function Name : log_get_num_entries
+
+Description : Returns the number of records in the log.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - The number of records.
+
+Changes :
+    N/A
+**/
+unsigned char log_get_num_entries(void) {
+    return logCount;
+}
+
+/**
+Function Name : log_get_record
+
+Description : Reads a record, counting from the oldest. A record not yet written back is read from
+    RAM; any other is decoded from its block, continuing from the cursor when the cursor is at or
+    before it in the same block. Whether the record is provisional is kept for log_get_provisional.
+
+Arguments :
+    (unsigned long) index - The index of the record, 0 being the oldest.
+    (unsigned long*) time - Receives the time of the record.
+    (unsigned char*) eventnum - Receives the EVENT_ code of the record.
+
+Returns :
+    (unsigned char) - 1 if the record exists, otherwise 0.
+
+Changes :
+    Log - The cursor is left after the record, and its provisional state kept.
+**/
+unsigned char log_get_record(unsigned long index, unsigned long *time, unsigned char *eventnum) {
+    unsigned long seq;
+    unsigned long pendingSeq;
+    unsigned char block;
+    unsigned char size;
+    unsigned char i;
+
+    if (index >= logCount) {
+        return 0;
+    }
+    seq = logFirstSeq + index;
+    pendingSeq = logFirstSeq + logCount - pendingLen;
+    if (seq >= pendingSeq) {
+        *time = pendingTime[seq - pendingSeq];
+        *eventnum = pendingEvent[seq - pendingSeq];
+        readProvisional = pendingProvisional;
+        for (i = 0; i <= seq - pendingSeq; i++) {
+            readProvisional = clockState(readProvisional, pendingEvent[i]);
+        }
+        return 1;
+    }
+
+    for (block = 0; block < LOG_BLOCKS; block++) {
+        if (blockCount[block] != 0 && seq >= blockSeq[block] && seq - blockSeq[block] < blockCount[block]) {
+            break;
+        }
+    }
+    if (block == LOG_BLOCKS) {
+        return 0;
+    }
+    if (!cursorValid || cursorBlock != block || cursorSeq > seq) {
+        cursorBlock = block;
+        cursorSeq = blockSeq[block];
+        cursorAddr = dataAddr(block);
+        cursorTime = 0;
+        cursorProvisional = blockProvisional[block];
+    }
+
+    do {
+        size = decodeRecord(cursorAddr, dataAddr(block) + LOG_DATA_SIZE - cursorAddr, cursorTime, time, eventnum);
+        if (size == 0) {
+            cursorValid = 0;
+            return 0;
+        }
+        cursorAddr += size;
+        cursorTime = *time;
+        cursorProvisional = clockState(cursorProvisional, *eventnum);
+        cursorSeq++;
+    } while (cursorSeq <= seq);
+    cursorValid = 1;
+    readProvisional = cursorProvisional;
+    return 1;
+}
+
+/**
+Function Name : log_get_provisional
+
+Description : Returns whether the record last read by log_get_record was stamped before the clock
+    was synchronized, between a TIMESET record and the NEWTIME record after it. The TIMESET record
+    itself is provisional; the NEWTIME record is not.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - 1 if the record's time is provisional, otherwise 0.
+
+Changes :
+    N/A
+**/
+unsigned char log_get_provisional(void) {
+    return readProvisional;
+}
+
+/**
+Function Name : log_get_first_seq
+
+Description : Returns the sequence number of the oldest record. The record at index i has sequence
+    number log_get_first_seq() + i, and the next record added gets log_get_first_seq() + count.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - The sequence number of the oldest record.
+
+Changes :
+    N/A
+**/
+unsigned long log_get_first_seq(void) {
+    return logFirstSeq;
+}
+
+/**
+Function Name : log_update
+
+Description : Writes the header after a clear, and the records added since the last call, back to
+    EEPROM. A record that starts a block first ends the block's old records and replaces its sequence
+    number. Each record is written after an end mark in the byte that follows it, head byte last.
+    Called from the write-back task of the cyclic executive.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The header and the pending records are written.
+    Log - No record is left pending.
+    Stats - The records and bytes written are counted.
+**/
+void log_update(void) {
+    unsigned char buf[LOG_HEADER_SIZE];
+    unsigned long seq;
+    unsigned char next;
+    unsigned char base;
+    unsigned char size;
+    unsigned char i;
+
+    if (logHeaderDirty) {
+        buf[0] = LOG_TOKEN;
+        buf[1] = 0;
+        putLong(buf + 2, logClearSeq);
+        writeChanged(LOG_ADDR, buf, LOG_HEADER_SIZE);
+        logHeaderDirty = 0;
+    }
+
+    while (pendingLen > 0) {
+        seq = logFirstSeq + logCount - pendingLen;
+        next = (writeBlock + 1) % LOG_BLOCKS;
+        base = blockCount[next] != 0 && blockSeq[next] == seq;
+        if (base) {
+            writeBlock = next;
+            writeAddr = dataAddr(next);
+            endRecords(writeAddr);
+            putLong(buf, seq);
+            writeChanged(writeAddr - 4, buf, 4);
+        }
+
+        size = encodeRecord(buf, pendingTime[0], writeTime, pendingEvent[0], base);
+        if (writeAddr + size < dataAddr(writeBlock) + LOG_DATA_SIZE) {
+            endRecords(writeAddr + size);
+        }
+        if (size > 1) {
+            writeChanged(writeAddr + 1, buf + 1, size - 1);
+        }
+        writeChanged(writeAddr, buf, 1);
+        writeAddr += size;
+        writeTime = pendingTime[0];
+        pendingProvisional = clockState(pendingProvisional, pendingEvent[0]);
+        stats_count(STATS_LOG_RECORDS);
+
+        pendingLen--;
+        for (i = 0; i < pendingLen; i++) {
+            pendingTime[i] = pendingTime[i + 1];
+            pendingEvent[i] = pendingEvent[i + 1];
+        }
+    }
+}
+
+/**
+Function Name : writeChanged
+
+Description : Writes a block to EEPROM, skipping the bytes that already hold the new value. Each run
+    of differing bytes is written with one eeprom_writebuf.
+
+Arguments :
+    (unsigned int) addr - EEPROM address of the block.
+    (unsigned char*) buf - The new contents of the block.
+    (unsigned char) size - Size of the block; at most LOG_HEADER_SIZE.
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The differing bytes are written.
+    Stats - The bytes written are counted.
+**/
+static void writeChanged(unsigned int addr, unsigned char* buf, unsigned char size) {
+    unsigned char old[LOG_HEADER_SIZE];
+    unsigned char i = 0;
+    unsigned char start;
+
+    eeprom_readbuf(addr, old, size);
+    while (i < size) {
+        if (old[i] == buf[i]) {
+            i++;
+            continue;
+        }
+        start = i;
+        while (i < size && old[i] != buf[i]) {
+            i++;
+        }
+        eeprom_writebuf(addr + start, buf + start, i - start);
+        stats_add(STATS_LOG_BYTES, i - start);
+    }
+}
+
+/**
+Function Name : getLong / putLong
+
+Description : Read and write a little endian 32-bit field of a header or record.
+**/
+static unsigned long getLong(unsigned char* buf) {
+    return (unsigned long)buf[0] | ((unsigned long)buf[1] << 8) |
+        ((unsigned long)buf[2] << 16) | ((unsigned long)buf[3] << 24);
+}
+
+static void putLong(unsigned char* buf, unsigned long value) {
+    buf[0] = (unsigned char)value;
+    buf[1] = (unsigned char)(value >> 8);
+    buf[2] = (unsigned char)(value >> 16);
+    buf[3] = (unsigned char)(value >> 24);
+}
@@ -0,0 +1,47 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for log.c; the EEPROM event log. Keeps the interface of the board
+    support library's log module, so the temperature FSM and the rest of the library link against
+    it unchanged, and adds a sequence number for every record. Records are delta-encoded in EEPROM;
+    45 to 120 of them are kept, depending on their spacing, and the oldest are dropped a block at a
+    time.
+**/
+#ifndef LOG_H_INCLUDED
+#define LOG_H_INCLUDED
+
+//DEFINES:
+#define EVENT_STARTUP   0x01
+#define EVENT_TIMESET   0x02
+#define EVENT_NEWTIME   0x03
+#define EVENT_HI_ALARM  0x04
+#define EVENT_HI_WARN   0x05
+#define EVENT_LO_WARN   0x06
+#define EVENT_LO_ALARM  0x07    //Highest code; the stored records hold event codes in 3 bits
+
+//DECLARATIONS:
+void log_init(void);    //Load the log from EEPROM
+
+void log_update(void);  //Write pending changes back to EEPROM
+
+void log_clear(void);   //Remove every record
+
+void log_add_record(unsigned char eventnum);    //Append a record stamped with the current time
+
+unsigned char log_get_num_entries(void);    //Number of records in the log
+
+unsigned char log_get_record(unsigned long index, unsigned long *time, unsigned char *eventnum);    //Read the record at 'index', 0 being the oldest
+
+unsigned char log_get_provisional(void);    //1 if the record last read was stamped before the clock was synchronized
+
+unsigned long log_get_first_seq(void);  //Sequence number of the oldest record; record i has sequence first + i
+
+#endif
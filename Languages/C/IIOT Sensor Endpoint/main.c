@@ -26,7 +26,6 @@ Description : Main entry point of program; initializes all the hardware to be us
 #include "vpd.h"
 #include "temp.h"
 #include "socket.h"
-#include "alarm.h"
 #include "wdt.h"
 #include "tempfsm.h"
 #include "eeprom.h"
@@ -34,13 +33,55 @@ Description : Main entry point of program; initializes all the hardware to be us
 #include "w51.h"
 #include "signature.h"
 #include "parser.h"
+#include "strbuf.h"
+#include "respcache.h"
+#include "sched.h"
+#include "writeback.h"
+#include "samples.h"
+#include "filter.h"
+#include "alarmq.h"
+#include "stats.h"
+#include "boot.h"
 
 //DEFINES:
 #define HTTP_PORT       8080	/* TCP port for HTTP */
-#define SERVER_SOCKET   0
+#define FLUSH_LINES_PER_PASS 4  /* request lines discarded per pass once a response is sent */
+#define TEMP_PERIOD_MS      SAMPLES_PERIOD_MS   /* temperature sampling period (see samples.h) */
+#define TEMP_STARTUP_MS     5000    /* first sample after startup, past the power-on spike */
+#define LED_PERIOD_MS       10      /* LED blink pattern update period */
+#define WRITEBACK_PERIOD_MS 100     /* EEPROM write-back task period (see writeback.c) */
 
 //DECLARATIONS:
 int current_temperature = 75;
+SOCKET serverSocket = SERVER_SOCKETS - 1;   /* socket serviced on the current pass */
+
+/**
+Function Name : sampleTemperature
+
+Description : Scheduled every TEMP_PERIOD_MS. Reads the temperature sensor, adds the reading to the
+    sample buffer served by GET /device/samples, runs it through the filter stages (see filter.c),
+    updates the temperature sensor finite state machine with the filtered temperature (which
+    classifies it, keeps it for the GET responses and queues any temperature alarms) and starts the
+    next conversion.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    current_temperature - Set to the sensor reading.
+    Samples - The reading is added to the sample buffer.
+    Filter - The filter stages are advanced by the reading.
+    Temp FSM - Updated with the reading and the config thresholds; holds the sample reported by GET.
+**/
+static void sampleTemperature(void) {
+    current_temperature = temp_get();
+    samples_add(current_temperature);
+    tempfsm_update(filter_apply(current_temperature),config.hi_alarm,config.hi_warn,config.lo_alarm,config.lo_warn);
+    temp_start();
+}
 
 /**
 Function Name : main()
@@ -59,10 +100,10 @@ Changes :
     UART - Initializes the hardware, then uses it to write text to the UART console regarding the connection state
         and the state of opening and closing connections.
     LED - Initializes the hardware, then sets the LED blink pattern/timing according to when the LED is updated
-        on each iteration through the cyclic executive. See the temp.h and tempfsm.h files for more information.
+        by its scheduled task every LED_PERIOD_MS. See the temp.h and tempfsm.h files for more information.
     VPD - Initialize the VPD struct in the EEPROM hardware.
-    Config - Initialize the config struct in the EEPROM hardware, then update its state every iteration through the cyclic executive
-        loop. Config struct values control the temperature limits in the system that flag other hardware used.
+    Config - Initialize the config struct in the EEPROM hardware, then write back its changes from the scheduled
+        write-back task. Config struct values control the temperature limits in the system that flag other hardware used.
     Log - Initialize the read of logs written to the EEPROM regarding events within the system.
     RTC - Initialize the RTC for date-time representations and the associated timer.
     SPI - Initializes the SPI library.
@@ -70,10 +111,34 @@ Changes :
         and update the temp values.
     W51 - Initializes and configures the W51 ethernet controller.
     Temp FSM - Initializes the temp FSM, then updates the FSM on changing temperature limits and updates in the system.
+    Samples - Initializes the sample buffer, then fills it from the scheduled temperature sampling task.
+    Filter - Loads the filter settings, then filters every sample before it reaches the temp FSM.
+    Alarm queue - Initializes the queue, then sends the queued alarms from its scheduled task every ALARMQ_PERIOD_MS
+        and flushes them before a restart.
+    Stats - Zeroes the counters, then times every pass of the executive and every requestFSM call for
+        GET /device/stats.
     Request FSM - Enters the request FSM when there is information in the receive buffer to be processed. Moves the system
-        into the next state in the FSM in which it will begin to parse and analyze the HTTP request.
+        into the next state in the FSM in which it will begin to parse and analyze the HTTP request. Each of the
+        SERVER_SOCKETS sockets listens on the HTTP port with its own request state, and one socket is serviced per
+        pass through the cyclic executive. Receiving, responding and flushing each do a bounded amount of work
+        per pass, so wdt_reset, led_update, temperature sampling and log_update keep running on schedule.
+        Connections are kept open between requests and only disconnected once the request FSM flags them
+        complete (the client asked to close, went away, or idled out). A GET /device/events with nothing new
+        to report holds its socket until a log record or state change arrives, checked once per pass.
+    Scheduler - Runs temperature sampling, the LED update and the EEPROM write-back as periodic tasks with
+        their own timers (see sched.c), and counts the time spent in passes where neither a task nor a
+        connection had anything to do.
+    Boot - After a requested restart, brings the server up with the lease and time cached before it, and
+        synchronizes with network time from a scheduled task instead of before the server listens
+        (see boot.c). The lease and time are cached on the way into every requested restart.
 **/
 int main(void) {
+    unsigned char lines;
+    unsigned char busy;
+    unsigned char result;
+    unsigned char fast;
+    unsigned long start;
+
 	/* Initialize the hardware devices
 	 * uart, led, vpd, config, log, rtc, spi,
      * temp sensor, W51 Ethernet controller, temp FSM
@@ -88,6 +153,14 @@ int main(void) {
      temp_init();
      W5x_init();
      tempfsm_init();
+     tempfsm_set_thresholds(config.hi_alarm,config.hi_warn,config.lo_alarm,config.lo_warn);
+     samples_init();
+     filter_init();
+     alarmq_init();
+     stats_init();
+
+    /* measure the static VPD block of the GET /device response, which every GET formats from the VPD */
+    respcache_init();
 
     /* sign the assignment
     * Asurite is the first part of your asu email (before the @asu.edu
@@ -98,110 +171,129 @@ int main(void) {
     unsigned char blank_addr[] = {0,0,0,0};
     W5x_config(vpd.mac_address, blank_addr, blank_addr, blank_addr);
 
-    /* loop until a dhcp address has been gotten */
-    while (!dhcp_start(vpd.mac_address, 60000UL, 4000UL)) {}
-    uart_writestr("local ip: ");uart_writeip(dhcp_getLocalIp());
+    /* right after a requested restart, reuse the cached lease and time (see boot.c); otherwise
+    * loop until a dhcp address has been gotten
+    */
+    fast = boot_restore();
+    if (!fast) {
+        while (!dhcp_start(vpd.mac_address, 60000UL, 4000UL)) {}
+        boot_set_lease(dhcp_getLocalIp(), dhcp_getGatewayIp(), dhcp_getSubnetMask());
+    }
+    uart_writestr("local ip: ");uart_writeip(boot_local_ip());
 
     /* configure the MAC, TCP, subnet and gateway addresses for the Ethernet controller*/
-    W5x_config(vpd.mac_address, dhcp_getLocalIp(), dhcp_getGatewayIp(), dhcp_getSubnetMask());
+    W5x_config(vpd.mac_address, boot_local_ip(), boot_gateway_ip(), boot_subnet_mask());
 
 	/* add a log record for EVENT_TIMESET prior to synchronizing with network time */
 	log_add_record(EVENT_TIMESET);
 
-    /* synchronize with network time */
-    ntp_sync_network_time(5);
-
-    /* add a log record for EVENT_NEWTIME now that time has been synchronized */
-    log_add_record(EVENT_NEWTIME);
+    /* synchronize with network time, and add a log record for EVENT_NEWTIME once it has been
+    * synchronized; a fast boot leaves both to its scheduled task
+    */
+    if (!fast) {
+        ntp_sync_network_time(5);
+        log_add_record(EVENT_NEWTIME);
+    }
 
     /* start the watchdog timer */
     wdt_init();
 
-    /* log the EVENT STARTUP and send and ALARM to the Master Controller */
+    /* log the EVENT STARTUP and queue an ALARM for the Master Controller; it is sent by the first
+    * run of the alarm queue task
+    */
     log_add_record(EVENT_STARTUP);
-    alarm_send(EVENT_STARTUP);
+    alarmq_post(EVENT_STARTUP);
 
     /* request start of test if 'T' key pressed - You may run up to 3 tests per
      * day.  Results will be e-mailed to you at the address asurite@asu.edu
      */
     check_for_test_start();
 
-    /* start the first temperature reading and wait 5 seconds before reading again
-    * this long delay ensures that the temperature spike during startup does not
-    * trigger any false alarms.
+    /* start the first temperature reading and schedule the periodic work; the first reading is
+    * taken 5 seconds from now so the temperature spike during startup does not trigger any
+    * false alarms. Each task keeps its own timer, so serving requests does not delay sampling.
     */
+    sched_init();
     temp_start();
-    delay_set(1,5000);
+    sched_add(sampleTemperature, TEMP_PERIOD_MS, TEMP_STARTUP_MS);
+    sched_add(led_update, LED_PERIOD_MS, 0);
+    sched_add(writeback_update, WRITEBACK_PERIOD_MS, WRITEBACK_PERIOD_MS);
+    sched_add(alarmq_update, ALARMQ_PERIOD_MS, 0);
+    if (fast) {
+        sched_add(boot_sync_update, BOOT_SYNC_RETRY_MS, BOOT_SYNC_DELAY_MS);
+    }
 
     while (1) {
-        /* reset  the watchdog timer every loop */
+        /* reset  the watchdog timer every loop, and time the pass that just ended */
         wdt_reset();
+        stats_pass();
 
-        /* update the LED blink state */
-        led_update();
+        /* run the temperature, LED, write-back and alarm tasks that are due */
+        busy = sched_run();
 
-        /* if the temperature sensor delay is done, update the current temperature
-        * from the temperature sensor, update the temperature sensor finite state
-        * machine (which provides hysteresis) and send any temperature sensor
-        * alarms (from FSM update).
-        */
-        if (delay_isdone(1)) {
-            /* read the temperature sensor */
-            current_temperature = temp_get();
-
-            /* update the temperature fsm and send any alarms associated with it */
-            tempfsm_update(current_temperature,config.hi_alarm,config.hi_warn,config.lo_alarm,config.lo_warn);
-
-            /* restart the temperature sensor delay to trigger in 1 second */
-            temp_start();
-            delay_set(1,1000);
+        //Service the next server socket; one socket is handled per pass so the sockets are
+        //  round-robined and no client waits on another client's connection
+        serverSocket++;
+        if (serverSocket == SERVER_SOCKETS) {
+            serverSocket = 0;
         }
 
-        //Check to see if the server socket is closed
-        if (socket_is_closed(SERVER_SOCKET)) {
+        //Check to see if the server socket is closed. A client that dropped the connection may have
+        //  left a request or response under way, so the request state is reset first
+        if (socket_is_closed(serverSocket)) {
             uart_writestr("\n\rOpening socket\n\r");
+            resetRequestState(serverSocket);
              //Open socket and place it in listen mode
-            socket_open(SERVER_SOCKET, HTTP_PORT);
-            socket_listen(SERVER_SOCKET);
+            socket_open(serverSocket, HTTP_PORT);
+            socket_listen(serverSocket);
+            busy = 1;
         }
 
-        //Check to see if there is anything in the receive buffer
-        if (socket_recv_available(SERVER_SOCKET) > 0) {
+        //Check to see if the processing has finished
+        if (connection[serverSocket].processComplete) {
+            //Flush rest of the data, a few lines per pass so a large request cannot stall the loop
+            lines = FLUSH_LINES_PER_PASS;
+            while (lines > 0 && socket_recv_available(serverSocket)) {
+                socket_flush_line(serverSocket);
+                lines--;
+            }
+            busy = 1;
 
-            //Check to see if the processing has finished
-            if (processComplete) {
+            //Once flushed, disconnect the socket and reset its request state
+            if (lines > 0) {
                 uart_writestr("Closing socket\n\r");
-                //Flush rest of the data
-                while (socket_recv_available(SERVER_SOCKET)) {
-                    socket_flush_line(SERVER_SOCKET);
-                }
-                uart_writestr("Socket flushed\n\r");
-                //Set processComplete back to 0 and disconnect the socket
-                processComplete = 0;
-                socket_disconnect(SERVER_SOCKET);
+                socket_disconnect(serverSocket);
+                resetRequestState(serverSocket);
 
                 //Check if restart was triggered. If so, set restart flag back to 0,
-                //  then set config to modified and update before requesting WDT restart
+                //  then send the queued alarms, write back the log and the modified config
+                //  and cache the lease and time for a fast boot before requesting WDT restart
                 if (restart == 1) {
                     restart = 0;
+                    alarmq_flush();
                     config_set_modified();
-                    config_update();
+                    writeback_flush();
+                    boot_save();
                     wdt_force_restart();
                 }
+            }
 
-            } else {
-            //Handle the request by calling the Request FSM
-            uart_writestr("Handling request\n\r");
-            requestFSM(SERVER_SOCKET);
-            delay_set(1, 2000);
+        //Advance the Request FSM by one step; it reads what has arrived, continues a response
+        //  still being written, and flags an idle keep-alive connection for closing
+        } else {
+            start = sched_now();
+            result = requestFSM(serverSocket);
+            stats_time(STATS_TIMER_FSM, sched_now() - start);
+            if (result == FSM_DISPATCHED) {
+                uart_writestr("Handling request\n\r");
+            }
+            if (result != FSM_IDLE) {
+                busy = 1;
             }
         }
 
-        /* update any pending log write backs */
-        log_update();
-
-        /* update any pending config write backs */
-        config_update();
+        /* count the time spent in passes that found nothing to do */
+        sched_account(busy);
     }
 	return 0;
 }
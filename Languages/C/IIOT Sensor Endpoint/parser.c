@@ -14,21 +14,78 @@ Description : File that contains the request FSM and all logic to build and hand
 **/
 
 //DEFINES:
-#define CRLF "\n\r"
-#define GET_REQUEST ((unsigned char)1)
-#define PUT_REQUEST_CRIT_HI ((unsigned char)2)
-#define PUT_REQUEST_WARN_HI ((unsigned char)3)
-#define PUT_REQUEST_CRIT_LO ((unsigned char)4)
-#define PUT_REQUEST_WARN_LO ((unsigned char)5)
-#define DELTE_LOG_REQUEST ((unsigned char)6)
-#define PUT_REQUEST_RESET ((unsigned char)7)
-#define PUT_REQUEST_NO_RESET ((unsigned char)8)
-#define INVALID ((unsigned char)9)
-#define LOW_ALARM ((unsigned char)10)
-#define LOW_WARN ((unsigned char)11)
-#define NORMAL ((unsigned char)12)
-#define HIGH_WARN ((unsigned char)13)
-#define HIGH_ALARM ((unsigned char)14)
+#define CRLF "\r\n"
+#define ROUTE_NONE ((unsigned char)0xFF)
+#define NO_MATCH ((unsigned char)0xFF)
+#ifndef RESPONSE_BUF_SIZE
+#define RESPONSE_BUF_SIZE 256
+#endif
+#define RESPONSE_BUDGET 512     //Characters of a GET response written per pass
+#define RESPONSE_HEADERS_MAX 112    //Longest status line and headers: a 400 with every header
+#define REQUEST_READ_BUDGET 256 //Characters of a request read per pass
+#define LOG_RECORDS_PER_RESPONSE 4  //Log records returned by one GET /device/log without a limit
+#define LOG_LIMIT_MAX 16        //Largest limit a GET /device/log may ask for
+
+//Request types: X(type, counter, status, parse, answer). A request line that walks the route trie
+//  to 'type' has the rest of its line (after the route's token) checked by 'parse', if there is
+//  one, and is then counted in the STATS_ 'counter', given the response code 'status' (2 for 200,
+//  4 for 400) and answered by 'answer', which returns 0 if the socket had no room for the response
+//  yet and it must be called again. The order of the rows sets the request codes.
+#define REQUEST_TABLE(X) \
+    X(INVALID,              STATS_REQ_INVALID,  4, 0,                   buildGeneralResponse) \
+    X(GET_REQUEST,          STATS_REQ_GET,      2, 0,                   answerGet) \
+    X(GET_BIN_REQUEST,      STATS_REQ_BIN,      2, 0,                   buildBinaryResponse) \
+    X(GET_LOG_REQUEST,      STATS_REQ_LOG,      2, parseLogQuery,       buildLogResponse) \
+    X(GET_SAMPLES_REQUEST,  STATS_REQ_SAMPLES,  2, parseCursor,         answerSamples) \
+    X(GET_EVENTS_REQUEST,   STATS_REQ_EVENTS,   2, parseEventsQuery,    answerEvents) \
+    X(GET_STATS_REQUEST,    STATS_REQ_STATS,    2, 0,                   buildStatsResponse) \
+    X(PUT_REQUEST_CONFIG,   STATS_REQ_CONFIG,   2, parseConfigQuery,    answerConfig) \
+    X(PUT_REQUEST_RESET,    STATS_REQ_RESET,    2, 0,                   answerReset) \
+    X(PUT_REQUEST_NO_RESET, STATS_REQ_RESET,    2, 0,                   buildGeneralResponse) \
+    X(DELTE_LOG_REQUEST,    STATS_REQ_DELETE,   2, 0,                   answerDeleteLog)
+
+//Nodes of the request-line trie: X(node, token, match, miss, type); see routeNode. The first row
+//  is the root, and nodes refer to each other by name.
+#define ROUTE_TABLE(X) \
+    X(ROUTE_GET,            "GET /device",          ROUTE_GET_LOG,      ROUTE_PUT,          INVALID) \
+    X(ROUTE_GET_LOG,        "/log",                 ROUTE_LOG_QUERY,    ROUTE_GET_BIN,      INVALID) \
+    X(ROUTE_GET_DEVICE,     "",                     ROUTE_NONE,         ROUTE_NONE,         GET_REQUEST) \
+    X(ROUTE_PUT,            "PUT /device",          ROUTE_PUT_CONFIG,   ROUTE_DELETE_LOG,   INVALID) \
+    X(ROUTE_PUT_CONFIG,     "/config?",             ROUTE_NONE,         ROUTE_RESET,        PUT_REQUEST_CONFIG) \
+    X(ROUTE_RESET,          "?reset=\"true\"",      ROUTE_NONE,         ROUTE_NO_RESET,     PUT_REQUEST_RESET) \
+    X(ROUTE_NO_RESET,       "?reset=\"false\"",     ROUTE_NONE,         ROUTE_NONE,         PUT_REQUEST_NO_RESET) \
+    X(ROUTE_DELETE_LOG,     "DELETE /device/log",   ROUTE_NONE,         ROUTE_NONE,         DELTE_LOG_REQUEST) \
+    X(ROUTE_LOG_QUERY,      "?",                    ROUTE_NONE,         ROUTE_LOG_ALL,      GET_LOG_REQUEST) \
+    X(ROUTE_LOG_ALL,        "",                     ROUTE_NONE,         ROUTE_NONE,         GET_LOG_REQUEST) \
+    X(ROUTE_GET_BIN,        ".bin",                 ROUTE_NONE,         ROUTE_SAMPLES,      GET_BIN_REQUEST) \
+    X(ROUTE_SAMPLES,        "/samples",             ROUTE_SAMPLES_SINCE, ROUTE_EVENTS,      INVALID) \
+    X(ROUTE_SAMPLES_SINCE,  "?since=",              ROUTE_NONE,         ROUTE_SAMPLES_ALL,  GET_SAMPLES_REQUEST) \
+    X(ROUTE_SAMPLES_ALL,    "",                     ROUTE_NONE,         ROUTE_NONE,         GET_SAMPLES_REQUEST) \
+    X(ROUTE_EVENTS,         "/events",              ROUTE_EVENTS_SINCE, ROUTE_STATS,        INVALID) \
+    X(ROUTE_EVENTS_SINCE,   "?since=",              ROUTE_NONE,         ROUTE_EVENTS_ALL,   GET_EVENTS_REQUEST) \
+    X(ROUTE_EVENTS_ALL,     "",                     ROUTE_NONE,         ROUTE_NONE,         GET_EVENTS_REQUEST) \
+    X(ROUTE_STATS,          "/stats",               ROUTE_NONE,         ROUTE_APPENDED,     GET_STATS_REQUEST) \
+    X(ROUTE_APPENDED,       "/",                    ROUTE_NONE,         ROUTE_GET_DEVICE,   INVALID)
+
+//Query keys of GET /device/log: X(index, key)
+#define LOG_KEY_TABLE(X) \
+    X(LOG_KEY_SINCE,    since) \
+    X(LOG_KEY_EVENT,    event) \
+    X(LOG_KEY_FROM,     from) \
+    X(LOG_KEY_TO,       to) \
+    X(LOG_KEY_LIMIT,    limit)
+
+#define REQUEST_CODE(type, counter, status, parse, answer) type,
+#define REQUEST_ENTRY(type, counter, status, parse, answer) {counter, status, parse, answer},
+#define ROUTE_ID(node, token, match, miss, type) node,
+#define ROUTE_TOKEN(node, token, match, miss, type) static const char node##_TOKEN[] PROGMEM = token;
+#define ROUTE_ENTRY(node, token, match, miss, type) {node##_TOKEN, match, miss, type},
+#define CONFIG_KEY(index, key, field) static const char index##_KEY[] PROGMEM = #key "=";
+#define CONFIG_KEY_ENTRY(index, key, field) index##_KEY,
+#define LOG_KEY_INDEX(index, key) index,
+#define LOG_KEY(index, key) static const char index##_KEY[] PROGMEM = #key "=";
+#define LOG_KEY_ENTRY(index, key) index##_KEY,
+#define TAKE_FILTER_SETTING(index, key, field) takeFilterSetting(&filter.field, values, mask, index) ||
 
 //INCLUDES:
 #include "vpd.h"
@@ -38,164 +95,1074 @@ Description : File that contains the request FSM and all logic to build and hand
 #include "parser.h"
 #include "uart.h"
 #include "temp.h"
+#include "tempfsm.h"
 #include "wdt.h"
 #include "rtc.h"
+#include "strbuf.h"
+#include "respcache.h"
+#include "binresp.h"
+#include "writeback.h"
+#include "samples.h"
+#include "filter.h"
+#include "sched.h"
+#include "stats.h"
+#include "progmem.h"
 
 //DECLARATIONS:
-unsigned char error;
+enum {REQUEST_TABLE(REQUEST_CODE) REQUEST_TYPES};
+enum {ROUTE_TABLE(ROUTE_ID) ROUTE_NODES};
+enum {LOG_KEY_TABLE(LOG_KEY_INDEX) LOG_KEYS};
+
+//Response writer; responses are collected here and flushed to the socket in RESPONSE_BUF_SIZE chunks
+strbuf response;
+char responseData[RESPONSE_BUF_SIZE];
+
+//Media types of the response bodies
+static const char jsonType[] PROGMEM = "application/vnd.api+json";
+static const char binaryType[] PROGMEM = "application/octet-stream";
+
+static void consumeLine(unsigned char n);   //Drop parsed characters from the line buffer
+static unsigned char matchText(char* line, unsigned char len, const char* text);    //Case-insensitive prefix match against a flash literal
+static unsigned char matchToken(char* line, unsigned char len, const char* token);  //Exact prefix match against a flash literal
+static unsigned char findKey(const char* const* keys, unsigned char count, char* query, unsigned char len, unsigned char* pos);  //Look up the key of a query pair
+static unsigned char parseConfigQuery(requestState* state, char* query, unsigned char len);    //Collect the settings of a config PUT
+static unsigned char parseLogQuery(requestState* state, char* query, unsigned char len);   //Collect the cursor and filter of a log GET
+static unsigned char takeCursor(requestState* state, char* query, unsigned char len, unsigned char* pos);   //Collect the cursor at the start of a query
+static unsigned char parseCursor(requestState* state, char* query, unsigned char len);     //Collect the cursor of a samples GET
+static unsigned char takeNumber(char* query, unsigned char len, unsigned char* pos, unsigned long* value);  //Parse an unsigned decimal number
+static unsigned char parseEventsQuery(requestState* state, char* query, unsigned char len);    //Collect the cursor and state of an events GET
+static void defaultQuery(requestState* state);   //Set the cursor, log query and state of a request without a query
+static unsigned char eventsPending(requestState* state);   //Whether a GET /device/events has something to report
+static unsigned char answerRequest(SOCKET s);  //Answer a complete request, once the socket has room
+static unsigned char answerGet(SOCKET s);        //Start a GET /device response
+static unsigned char answerSamples(SOCKET s);    //Answer a GET /device/samples
+static unsigned char answerEvents(SOCKET s);     //Answer a GET /device/events now, or hold it
+static unsigned char answerConfig(SOCKET s);     //Apply a config PUT and answer it
+static unsigned char answerReset(SOCKET s);      //Answer a reset PUT and restart
+static unsigned char answerDeleteLog(SOCKET s);  //Answer a DELETE /device/log and clear the log
+
+//What is done with each type of request, indexed by request code
+typedef struct {
+    unsigned char counter;
+    unsigned char status;
+    unsigned char (*parse)(requestState* state, char* query, unsigned char len);
+    unsigned char (*answer)(SOCKET s);
+} requestEntry;
+
+static const requestEntry requests[REQUEST_TYPES] PROGMEM = {REQUEST_TABLE(REQUEST_ENTRY)};
+
+//Node of the request-line trie. Each node holds the literal that must follow the text matched
+//so far. On a match the walk continues at 'match', or ends with 'type' when 'match' is ROUTE_NONE;
+//on a mismatch it tries the sibling at 'miss', and ends with INVALID when there is none.
+typedef struct {
+    const char* token;
+    unsigned char match;
+    unsigned char miss;
+    unsigned char type;
+} routeNode;
+
+ROUTE_TABLE(ROUTE_TOKEN)
+static const routeNode routes[ROUTE_NODES] PROGMEM = {ROUTE_TABLE(ROUTE_ENTRY)};
+
+//Query keys of PUT /device/config, indexed by CONFIG_ index
+CONFIG_THRESHOLD_TABLE(CONFIG_KEY)
+CONFIG_FILTER_TABLE(CONFIG_KEY)
+static const char* const configKeys[CONFIG_FIELDS] PROGMEM = {
+    CONFIG_THRESHOLD_TABLE(CONFIG_KEY_ENTRY) CONFIG_FILTER_TABLE(CONFIG_KEY_ENTRY)
+};
+
+//Query keys of GET /device/log, indexed by LOG_KEY_ index
+LOG_KEY_TABLE(LOG_KEY)
+static const char* const logKeys[LOG_KEYS] PROGMEM = {LOG_KEY_TABLE(LOG_KEY_ENTRY)};
 
 /**
 Function Name : requestFSM
 
-Description : FSM for receiving HTTP requests. Entry point is receiving a request in the socket buffer.
-    After receiving, the initial string in the buffer is compared to see if it is a GET, PUT, DELETE, or
-    invalid request. Upon validation, the system moves to the next phase to validate the type of request received.
-    Thereafter, the request is either given an error code of 200 or 400 depending on the validation of the
-    request. An appropriate HTTP response is then built and sent to the server.
+Description : FSM for receiving HTTP requests. Entry point is receiving a request in the socket
+    buffer. Received characters are collected in the line buffer and taken out of it a line at a
+    time, reading up to REQUEST_READ_BUDGET characters per call. The request line is matched against
+    the route trie to see if it is a GET, PUT, DELETE, or invalid request, the header lines are
+    scanned for the headers that frame the request (Connection, Content-Length), and any request
+    body is discarded. Once the blank line that ends the headers (and the body) has been consumed,
+    the request is given an error code of 200 or 400 depending on its validation and an appropriate
+    HTTP response is built and sent, as the request's row of REQUEST_TABLE says. A GET response is
+    written over as many calls as it needs, RESPONSE_BUDGET characters at a time, so each call does
+    a bounded amount of work and the cyclic executive is never stalled by a slow or large request.
+    Nothing is written until the socket's transmit buffer has room for it, so a client that reads
+    slowly cannot stall the executive either: a request whose response does not fit yet is held in
+    PHASE_ANSWER and answered on a later call (see answerRequest).
+
+    Connections are persistent: responses carry a Content-Length and the connection stays open for the
+    next request unless the client asked for it to be closed or spoke HTTP/1.0. Because only the
+    characters of the current request are consumed, the next of several pipelined requests is left in
+    the line buffer and is handled on a following call. An idle connection is closed once the client
+    has gone away or after KEEPALIVE_TIMEOUT seconds.
+
+    There is one line buffer for all the server sockets, as a buffer per socket would cost SRAM the
+    AVR does not have. The socket whose characters are in it owns it until they have all been
+    parsed; the others leave what they have received in the W5x until then. A line normally arrives
+    whole and is parsed in the call that reads it, so the buffer is only held across calls by a
+    line split between segments, or by pipelined requests read along with the one being answered.
+    A client that stops partway through a line is dropped after KEEPALIVE_TIMEOUT seconds like an
+    idle one, so it cannot hold the buffer for longer.
+
+    A GET /device/events with nothing to report yet is held in PHASE_WAIT: each call checks whether
+    a log record or a state change has arrived, answers as soon as one has (or after EVENTS_TIMEOUT
+    seconds), and otherwise returns at once without touching the socket, so a waiting subscriber
+    costs a few comparisons per pass.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to. The request state
+        for the socket is kept in connection[s].
+
+Returns :
+    (unsigned char) - FSM_DISPATCHED if a request was dispatched by this call, FSM_BUSY if data was
+        received or a response written, otherwise FSM_IDLE.
+
+Changes :
+    Request FSM - Moves the system into the request FSM when called. Then moves the system through the FSM
+        by validating the request line, validating the request itself, and then sending the system into
+        the state where it builds the corresponding HTTP response code. State is kept in connection[s]
+        between calls, and processComplete is set when the connection should be closed.
+**/
+unsigned char requestFSM(SOCKET s) {
+    requestState* state = &connection[s];
+    unsigned int avail;
+    unsigned int budget;
+    unsigned int len;
+    unsigned char i;
+    unsigned char end;
+    unsigned char skipped;
+    unsigned char held;
+    const requestEntry* entry;
+
+    //Answer a complete request that was waiting for room in the socket's transmit buffer
+    if (state->phase == PHASE_ANSWER) {
+        return answerRequest(s) ? FSM_DISPATCHED : FSM_IDLE;
+    }
+
+    //Continue a GET response that is already under way
+    if (state->phase == PHASE_RESPONSE) {
+        buildGetResponse(s);
+        return FSM_BUSY;
+    }
+
+    //Answer a waiting GET /device/events once there is news or it times out; drop it if the client left
+    if (state->phase == PHASE_WAIT) {
+        if (!socket_is_established(s)) {
+            state->phase = PHASE_REQUEST;
+            state->processComplete = 1;
+            return FSM_IDLE;
+        }
+        if (!eventsPending(state) && rtc_get_date() - state->lastActive < EVENTS_TIMEOUT) {
+            return FSM_IDLE;
+        }
+        return buildEventsResponse(s) ? FSM_BUSY : FSM_IDLE;
+    }
+
+    //Nothing to do; close an idle connection once the client has gone away or timed out
+    held = requestLine.len > 0 && requestLine.owner == s;
+    avail = socket_recv_available(s);
+    if (avail == 0 && !held) {
+        if (state->connected && (!socket_is_established(s) ||
+                rtc_get_date() - state->lastActive > KEEPALIVE_TIMEOUT)) {
+            state->processComplete = 1;
+        }
+        return FSM_IDLE;
+    }
+
+    //Leave the characters in the W5x while the line buffer holds another connection's
+    if (requestLine.len > 0 && !held) {
+        return FSM_IDLE;
+    }
+    requestLine.owner = s;
+
+    //Take complete lines out of the buffer until the request is complete or more data is needed
+    budget = REQUEST_READ_BUDGET;
+    while (1) {
+        //Top the line buffer up from what has arrived, within this call's read budget
+        len = REQUEST_LINE_MAX - requestLine.len;
+        if (len > avail) {
+            len = avail;
+        }
+        if (len > budget) {
+            len = budget;
+        }
+        if (len > 0) {
+            avail -= len;
+            budget -= len;
+            requestLine.len += socket_recv(s, (unsigned char*)requestLine.data + requestLine.len, len);
+            state->connected = 1;
+            state->lastActive = rtc_get_date();
+        }
+
+        //Discard the request body
+        if (state->phase == PHASE_BODY) {
+            len = state->bodyLeft < requestLine.len ? state->bodyLeft : requestLine.len;
+            consumeLine(len);
+            state->bodyLeft -= len;
+            if (state->bodyLeft == 0) {
+                break;
+            }
+            if (avail == 0 || budget == 0) {
+                return budget < REQUEST_READ_BUDGET ? FSM_BUSY : FSM_IDLE;
+            }
+            continue;
+        }
+
+        //Wait for the end of the line, unless the line buffer is already full. A client that has
+        //  stopped partway through a line is dropped once it has been idle for KEEPALIVE_TIMEOUT
+        for (i = 0; i < requestLine.len && requestLine.data[i] != '\n'; i++) {}
+        if (i == requestLine.len && requestLine.len < REQUEST_LINE_MAX) {
+            if (avail == 0 && rtc_get_date() - state->lastActive > KEEPALIVE_TIMEOUT) {
+                state->processComplete = 1;
+            }
+            if (avail == 0 || budget == 0) {
+                return budget < REQUEST_READ_BUDGET ? FSM_BUSY : FSM_IDLE;
+            }
+            continue;
+        }
+
+        //A full buffer is taken as a truncated line; the rest of it is skipped when it arrives, and
+        //  a truncated line is not parsed
+        skipped = state->skipLine;
+        state->skipLine = (i == requestLine.len);
+        end = i;
+        if (end > 0 && requestLine.data[end - 1] == '\r') {
+            end--;
+        }
+
+        if (!skipped) {
+            if (state->phase == PHASE_REQUEST) {
+                //Blank lines between pipelined requests are ignored. A request line that did not fit
+                //  in the buffer is answered 400 without being parsed, as the part cut off may have
+                //  changed its meaning, and its connection is closed
+                if (end > 0) {
+                    state->value = 0;
+                    if (state->skipLine) {
+                        state->requestType = INVALID;
+                        state->keepAlive = 0;
+                    } else {
+                        state->requestType = parseRequestLine(requestLine.data, end, state);
+                        state->keepAlive = end >= 8 && matchText(requestLine.data + end - 8, 8, PSTR("http/1.1"));
+                    }
+                    state->bodyLeft = 0;
+                    state->binary = 0;
+                    state->phase = PHASE_HEADERS;
+                }
+            } else if (end == 0) {
+                //End of the headers
+                state->phase = PHASE_BODY;
+            } else if (!state->skipLine) {
+                //A header cut short is ignored, as the part cut off may have changed its meaning
+                parseHeaderLine(state, requestLine.data, end);
+            }
+        }
+        consumeLine(state->skipLine ? i : i + 1);
+    }
+
+    state->processComplete = 0;
+
+    //A GET /device that accepts the binary form is answered with it
+    if (state->requestType == GET_REQUEST && state->binary) {
+        state->requestType = GET_BIN_REQUEST;
+    }
+
+    //Count the request and answer it as its entry in the request table says
+    entry = &requests[state->requestType];
+    stats_count(pgm_read_byte(&entry->counter));
+    state->error = pgm_read_byte(&entry->status);
+    return answerRequest(s) ? FSM_DISPATCHED : FSM_BUSY;
+}
+
+/**
+Function Name : answerRequest
+
+Description : Answers a complete request as its entry in the request table says. The answers only
+    write once the socket's transmit buffer has room for the whole of what they write, as the board
+    library would otherwise wait in socket_writebuf for the client to make room and stall the cyclic
+    executive. An answer that finds too little room does nothing and returns 0; the request is then
+    held in PHASE_ANSWER and answered on a later call, unless the client has gone away.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the request was answered, or 0 if it is still waiting for room.
+
+Changes :
+    Request FSM - The connection leaves PHASE_ANSWER once the request is answered (for the phase
+        the answer puts it in), or enters it to wait for room.
+    Ethernet - See the answer functions.
+**/
+static unsigned char answerRequest(SOCKET s) {
+    requestState* state = &connection[s];
+    unsigned char (*answer)(SOCKET s);
+
+    answer = (unsigned char (*)(SOCKET))pgm_read_ptr(&requests[state->requestType].answer);
+    state->phase = PHASE_REQUEST;
+    if (answer(s)) {
+        return 1;
+    }
+
+    state->phase = PHASE_ANSWER;
+    if (!socket_is_established(s)) {
+        state->phase = PHASE_REQUEST;
+        state->processComplete = 1;
+    }
+    return 0;
+}
+
+/**
+Function Name : answerGet
+
+Description : Answers a GET /device, starting the response cursor at the top of the document. The
+    rest of the response is written by later calls of the request FSM.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1; the response waits for room in the transmit buffer pass by pass itself.
+
+Changes :
+    Request FSM - The connection enters PHASE_RESPONSE.
+    Response cache - The cache is held until the response is complete.
+**/
+static unsigned char answerGet(SOCKET s) {
+    requestState* state = &connection[s];
+
+    state->phase = PHASE_RESPONSE;
+    state->part = RESPCACHE_PART_HEADER;
+    state->entry = 0;
+    state->length = respcache_begin();
+    buildGetResponse(s);
+    return 1;
+}
+
+/**
+Function Name : answerSamples
+
+Description : Answers a GET /device/samples with the samples after the cursor and the aggregates.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+**/
+static unsigned char answerSamples(SOCKET s) {
+    return buildSamplesResponse(s, (unsigned long)connection[s].value);
+}
+
+/**
+Function Name : answerEvents
+
+Description : Answers a GET /device/events at once if there is news, otherwise holds it in PHASE_WAIT
+    until there is (see requestFSM).
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 0 if there is news but the socket had no room for the response, otherwise 1.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - The connection may enter PHASE_WAIT.
+**/
+static unsigned char answerEvents(SOCKET s) {
+    requestState* state = &connection[s];
+
+    if (eventsPending(state)) {
+        return buildEventsResponse(s);
+    }
+    state->phase = PHASE_WAIT;
+    return 1;
+}
+
+/**
+Function Name : answerConfig
+
+Description : Applies the settings of a PUT /device/config, all of them or none, and answers 200 if
+    they were applied or 400 if they were not. Nothing is applied until the socket has room for the
+    answer, so a call that has to be repeated does not apply the settings twice.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the settings were handled and answered, or 0 if the socket had no room.
+
+Changes :
+    Config - See update_config.
+    Ethernet - Writes HTTP response information to the Ethernet device.
+**/
+static unsigned char answerConfig(SOCKET s) {
+    requestState* state = &connection[s];
+
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX) {
+        return 0;
+    }
+    if (update_config(state->config, state->configMask) != 0) {
+        state->error = 4;
+    }
+    return buildGeneralResponse(s);
+}
+
+/**
+Function Name : answerReset
+
+Description : Answers a PUT /device?reset="true" and forces a system restart once it has been sent;
+    the connection is closed first.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Main - restart is set once the response is written.
+**/
+static unsigned char answerReset(SOCKET s) {
+    connection[s].keepAlive = 0;
+    if (!buildGeneralResponse(s)) {
+        return 0;
+    }
+    restart = 1;
+    return 1;
+}
+
+/**
+Function Name : answerDeleteLog
+
+Description : Answers a DELETE /device/log and deletes the current log entries.
 
 Arguments :
     (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
 
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Log - The log is cleared once the response is written.
+**/
+static unsigned char answerDeleteLog(SOCKET s) {
+    if (!buildGeneralResponse(s)) {
+        return 0;
+    }
+    log_clear();
+    return 1;
+}
+
+/**
+Function Name : resetRequestState
+
+Description : Returns the request state of a socket to that of a fresh connection. Called once the
+    socket has been disconnected, and again before a closed socket is reopened (the client may
+    have dropped the connection mid-request), so nothing received on the old connection is parsed
+    as part of the next one.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the disconnected socket.
+
+Returns :
+    void
+
+Changes :
+    Request FSM - connection[s] is reset to wait for a request line, and the line buffer is
+        released if it held characters of the old connection.
+    Response cache - A GET response that was cut short releases the cache.
+**/
+void resetRequestState(SOCKET s) {
+    requestState* state = &connection[s];
+
+    if (state->phase == PHASE_RESPONSE) {
+        respcache_end();
+    }
+    state->phase = PHASE_REQUEST;
+    state->processComplete = 0;
+    state->skipLine = 0;
+    if (requestLine.owner == s) {
+        requestLine.len = 0;
+    }
+    state->connected = 0;
+}
+
+/**
+Function Name : consumeLine
+
+Description : Removes characters that have been parsed from the front of the line buffer, keeping
+    whatever follows them (the rest of the request, or a pipelined request). The buffer is free for
+    any connection once it is empty.
+
+Arguments :
+    (unsigned char) n - The number of characters to remove.
+
+Returns :
+    void
+
+Changes :
+    Request FSM - The line buffer is shortened by n characters.
+**/
+static void consumeLine(unsigned char n) {
+    unsigned char i;
+
+    requestLine.len -= n;
+    for (i = 0; i < requestLine.len; i++) {
+        requestLine.data[i] = requestLine.data[i + n];
+    }
+}
+
+/**
+Function Name : matchText
+
+Description : Case-insensitive comparison of the start of a line against a lower case literal kept in
+    program memory.
+
+Arguments :
+    (char*) line - The characters to compare.
+    (unsigned char) len - The number of valid characters in 'line'.
+    (const char*) text - The literal, in program memory (PSTR); letters must be lower case.
+
+Returns :
+    (unsigned char) - 1 if 'line' starts with 'text', otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char matchText(char* line, unsigned char len, const char* text) {
+    unsigned char i;
+    char t;
+    char c;
+
+    for (i = 0; (t = pgm_read_byte(&text[i])) != '\0'; i++) {
+        if (i == len) {
+            return 0;
+        }
+        c = line[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != t) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+Function Name : matchToken
+
+Description : Exact comparison of the start of a line against a literal kept in program memory.
+
+Arguments :
+    (char*) line - The characters to compare.
+    (unsigned char) len - The number of valid characters in 'line'.
+    (const char*) token - The literal, in program memory.
+
+Returns :
+    (unsigned char) - The length of 'token' if 'line' starts with it, otherwise NO_MATCH.
+
+Changes :
+    N/A
+**/
+static unsigned char matchToken(char* line, unsigned char len, const char* token) {
+    unsigned char i;
+    char c;
+
+    for (i = 0; (c = pgm_read_byte(&token[i])) != '\0'; i++) {
+        if (i == len || line[i] != c) {
+            return NO_MATCH;
+        }
+    }
+    return i;
+}
+
+/**
+Function Name : findKey
+
+Description : Looks up the "key=" at a position of a query in a table of keys kept in program memory.
+
+Arguments :
+    (const char* const*) keys - The table of keys, each with its '='.
+    (unsigned char) count - The number of keys in the table.
+    (char*) query - The query.
+    (unsigned char) len - The number of characters in the query.
+    (unsigned char*) pos - The position of the key; moved past it when it is found.
+
+Returns :
+    (unsigned char) - The index of the key, or 'count' if it is none of them.
+
+Changes :
+    N/A
+**/
+static unsigned char findKey(const char* const* keys, unsigned char count, char* query, unsigned char len, unsigned char* pos) {
+    unsigned char key;
+    unsigned char n;
+
+    for (key = 0; key < count; key++) {
+        n = matchToken(query + *pos, len - *pos, (const char*)pgm_read_ptr(&keys[key]));
+        if (n != NO_MATCH) {
+            *pos += n;
+            break;
+        }
+    }
+    return key;
+}
+
+/**
+Function Name : parseHeaderLine
+
+Description : Checks one request header line for the headers that decide how the request is framed.
+    "Connection: close" closes the connection after the response, an Accept header that lists
+    application/octet-stream selects the binary GET /device response, and Content-Length gives the
+    size of a request body to discard. All other headers are ignored.
+
+Arguments :
+    (requestState*) state - The connection's request state.
+    (char*) line - The header line, without its line ending.
+    (unsigned char) len - The number of valid characters in 'line'.
+
+Returns :
+    void
+
+Changes :
+    Request FSM - keepAlive, binary and bodyLeft are updated from the headers.
+**/
+void parseHeaderLine(requestState* state, char* line, unsigned char len) {
+    unsigned char pos;
+
+    if (matchText(line, len, PSTR("connection:"))) {
+        for (pos = 11; pos < len && line[pos] == ' '; pos++) {}
+        if (matchText(line + pos, len - pos, PSTR("close"))) {
+            state->keepAlive = 0;
+        }
+    } else if (matchText(line, len, PSTR("accept:"))) {
+        for (pos = 7; pos < len && !state->binary; pos++) {
+            state->binary = matchText(line + pos, len - pos, binaryType);
+        }
+    } else if (matchText(line, len, PSTR("content-length:"))) {
+        state->bodyLeft = 0;
+        for (pos = 15; pos < len && line[pos] == ' '; pos++) {}
+        while (pos < len && line[pos] >= '0' && line[pos] <= '9') {
+            state->bodyLeft = state->bodyLeft * 10 + (line[pos] - '0');
+            pos++;
+        }
+    }
+}
+
+/**
+Function Name : parseRequestLine
+
+Description : Walks the request-line trie over a request line that has already been read out of the
+    socket, producing the requestType for it in a single pass. The rest of the line is then checked
+    by the parser in the type's row of REQUEST_TABLE: for the samples and events cursors, the integer
+    that follows the query key is parsed into state->value, and for the events cursor an optional
+    "&state=S" into state->seenState (see parseCursor, parseEventsQuery); for a log GET, the cursor
+    and filter are collected into state->value and state->log (see parseLogQuery); for a config PUT,
+    the settings in the query are collected into state->config (see parseConfigQuery). A route
+    that ends on an empty token is the form of a log, samples or events GET without a query: the
+    space must follow the route's name, which rejects "/device/samples123", and the request gets
+    the default query (see defaultQuery). The trie and its tokens are read from program memory.
+
+Arguments :
+    (char*) line - The start of the request line.
+    (unsigned char) len - The number of valid characters in 'line'.
+    (requestState*) state - Receives the cursor or the requested settings; left alone for other
+        requests.
+
+Returns :
+    (unsigned char) - The requestType code for the request line, INVALID if it matches no route or
+        carries a malformed config or log query or events state.
+
+Changes :
+    N/A
+**/
+unsigned char parseRequestLine(char* line, unsigned char len, requestState* state) {
+    unsigned char node = 0;
+    unsigned char pos = 0;
+    unsigned char n;
+    unsigned char type;
+    unsigned char (*parse)(requestState* state, char* query, unsigned char len);
+
+    while (node != ROUTE_NONE) {
+        const routeNode* route = &routes[node];
+
+        //Compare the node's token against the line at the current position
+        n = matchToken(line + pos, len - pos, (const char*)pgm_read_ptr(&route->token));
+        if (n == NO_MATCH) {
+            node = pgm_read_byte(&route->miss);
+            continue;
+        }
+        pos += n;
+        node = pgm_read_byte(&route->match);
+        if (node == ROUTE_NONE) {
+            //Check the rest of the line with the request type's parser, which stores the cursor,
+            //  the log query or the requested settings. A type without a parser takes no more than
+            //  an ignored query: its token must be followed by the space or a '?'. An empty token is
+            //  the form of a route without a query, which must be followed by the space
+            type = pgm_read_byte(&route->type);
+            parse = (unsigned char (*)(requestState*, char*, unsigned char))pgm_read_ptr(&requests[type].parse);
+            if (parse == 0) {
+                return pos < len && (line[pos] == ' ' || line[pos] == '?') ? type : INVALID;
+            }
+            if (n == 0) {
+                defaultQuery(state);
+                return pos < len && line[pos] == ' ' ? type : INVALID;
+            }
+            return parse(state, line + pos, len - pos) ? type : INVALID;
+        }
+    }
+
+    return INVALID;
+}
+
+/**
+Function Name : takeCursor
+
+Description : Collects the cursor of a GET /device/samples or GET /device/events, the integer at the
+    start of the query, and sets the log query and temperature state that go unused with it to their
+    defaults. A request line without a query never gets here (see parseRequestLine), so an empty
+    "since=" has no cursor at all.
+
+Arguments :
+    (requestState*) state - Receives the cursor in 'value'.
+    (char*) query - The query, just after "?since=".
+    (unsigned char) len - The number of characters in the rest of the request line.
+    (unsigned char*) pos - Receives the position after the cursor.
+
+Returns :
+    (unsigned char) - 1 if there was a cursor that fits in 32 bits, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char takeCursor(requestState* state, char* query, unsigned char len, unsigned char* pos) {
+    unsigned long value;
+
+    defaultQuery(state);
+    *pos = 0;
+    if (!takeNumber(query, len, pos, &value)) {
+        return 0;
+    }
+    state->value = (long)value;
+    return 1;
+}
+
+/**
+Function Name : parseCursor
+
+Description : Collects the cursor of a GET /device/samples (see takeCursor), which must be followed
+    by the space before the protocol.
+
+Arguments :
+    (requestState*) state - Receives the cursor in 'value'.
+    (char*) query - The query, just after "?since=".
+    (unsigned char) len - The number of characters in the rest of the request line.
+
+Returns :
+    (unsigned char) - 1 if there is a valid cursor and nothing else, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char parseCursor(requestState* state, char* query, unsigned char len) {
+    unsigned char pos;
+
+    return takeCursor(state, query, len, &pos) && pos < len && query[pos] == ' ';
+}
+
+/**
+Function Name : parseEventsQuery
+
+Description : Collects the cursor of a GET /device/events (see takeCursor) and the temperature
+    state the client last saw, from an optional "&state=S" after the cursor.
+
+Arguments :
+    (requestState*) state - Receives the cursor in 'value' and the state in 'seenState'.
+    (char*) query - The query, just after "?since=".
+    (unsigned char) len - The number of characters in the rest of the request line.
+
+Returns :
+    (unsigned char) - 1 if there is a valid cursor and state and nothing else, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char parseEventsQuery(requestState* state, char* query, unsigned char len) {
+    unsigned char pos;
+
+    if (!takeCursor(state, query, len, &pos)) {
+        return 0;
+    }
+    if (matchText(query + pos, len - pos, PSTR("&state="))) {
+        pos += 7;
+        if (pos == len || query[pos] < '0' || query[pos] > '0' + TEMP_HIGH_CRITICAL) {
+            return 0;
+        }
+        state->seenState = query[pos] - '0';
+        pos++;
+    }
+    return pos < len && query[pos] == ' ';
+}
+
+/**
+Function Name : parseConfigQuery
+
+Description : Collects the settings of a PUT /device/config query, "key=value" pairs separated by
+    '&' up to the space before the protocol. Each of tcrit_hi, twarn_hi, twarn_lo, tcrit_lo,
+    filt_median, filt_ema, filt_slew and filt_hyst may be given once, in any order. A value is
+    collected in a long and must be at most CONFIG_VALUE_MAX, so it fits the 16-bit int of the AVR
+    whatever its digits. A query that is not followed by the space, as when the line was cut short,
+    is rejected.
+
+Arguments :
+    (requestState*) state - Receives the values in 'config' and the keys given in 'configMask'.
+    (char*) query - The query, just after the '?'.
+    (unsigned char) len - The number of characters in the rest of the request line.
+
+Returns :
+    (unsigned char) - 1 if the query holds at least one setting in range and nothing else, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char parseConfigQuery(requestState* state, char* query, unsigned char len) {
+    unsigned char pos = 0;
+    unsigned char key;
+    unsigned char digits;
+    int sign;
+    long value;
+
+    state->configMask = 0;
+    while (1) {
+        //Find the key
+        key = findKey(configKeys, CONFIG_FIELDS, query, len, &pos);
+        if (key == CONFIG_FIELDS || (state->configMask & (1 << key))) {
+            return 0;
+        }
+
+        //Its value
+        sign = 1;
+        value = 0;
+        digits = 0;
+        if (pos < len && query[pos] == '-') {
+            sign = -1;
+            pos++;
+        }
+        while (pos < len && query[pos] >= '0' && query[pos] <= '9' && digits < CONFIG_DIGITS_MAX) {
+            value = value * 10 + (query[pos] - '0');
+            pos++;
+            digits++;
+        }
+        if (digits == 0 || value > CONFIG_VALUE_MAX) {
+            return 0;
+        }
+        state->config[key] = sign * (int)value;
+        state->configMask |= 1 << key;
+
+        //Another pair, or the end of the query
+        if (pos < len && query[pos] == '&') {
+            pos++;
+        } else {
+            return pos < len && query[pos] == ' ';
+        }
+    }
+}
+
+/**
+Function Name : defaultQuery
+
+Description : Gives a log, samples or events request the query of a request line without one: a
+    cursor of 0, the first LOG_RECORDS_PER_RESPONSE records whatever their event or time, and no
+    temperature state. The query parsers start from these and change what their query gives.
+
+Arguments :
+    (requestState*) state - Receives the cursor in 'value', the log query in 'log' and the state
+        in 'seenState'.
+
 Returns :
     void
 
 Changes :
-    Request FSM - Moves the system into the request FSM when called. Then moves the system through the FSM
-        by validating the request line, validating the request itself, and then sending the system into
-        the state where it builds the corresponding HTTP response code.
-**/
-void requestFSM(SOCKET s) {
-    processComplete = 0;
-    int value;
-
-    //GET REQUEST:
-    if (socket_recv_compare(s, "GET")) {
-        if (socket_recv_compare(s, " /device")) {
-            //Check for appended GET request
-            if (socket_recv_compare(s, "/")) {
-                requestType = INVALID;
-            } else {
-                requestType = GET_REQUEST;
-            }
-        } else {
-            requestType = INVALID;
-        }
-
-    //PUT REQUESTS:
-    } else if (socket_recv_compare(s, "PUT /device")) {
-        //Modifying config values
-        if (socket_recv_compare(s, "/config?")) {
-            //Retrieve config value to modify
-            if (socket_recv_compare(s, "tcrit_hi=")) {
-                requestType = PUT_REQUEST_CRIT_HI;
-            } else if (socket_recv_compare(s, "twarn_hi=")) {
-                requestType = PUT_REQUEST_WARN_HI;
-            } else if (socket_recv_compare(s, "tcrit_lo=")) {
-                requestType = PUT_REQUEST_CRIT_LO;
-            } else if (socket_recv_compare(s, "twarn_lo=")) {
-                requestType = PUT_REQUEST_WARN_LO;
-            } else {
-                //Invalid entry
-                requestType = INVALID;
-            }
+    N/A
+**/
+static void defaultQuery(requestState* state) {
+    state->value = 0;
+    state->log.events = 0;
+    state->log.limit = LOG_RECORDS_PER_RESPONSE;
+    state->log.from = 0;
+    state->log.to = 0xFFFFFFFFUL;
+    state->seenState = EVENTS_ANY_STATE;
+}
 
-            //Store the requested config modification into the 'value' variable.
-            if (requestType != INVALID) {
-                socket_recv_int(s, &value);
-            }
+/**
+Function Name : takeNumber
+
+Description : Parses the unsigned decimal number at a position of a query.
+
+Arguments :
+    (char*) query - The query.
+    (unsigned char) len - The number of characters in the query.
+    (unsigned char*) pos - The position of the number; moved past it.
+    (unsigned long*) value - Receives the number.
+
+Returns :
+    (unsigned char) - 1 if there was a number that fits in 32 bits, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char takeNumber(char* query, unsigned char len, unsigned char* pos, unsigned long* value) {
+    unsigned char digits = 0;
+
+    *value = 0;
+    while (*pos < len && query[*pos] >= '0' && query[*pos] <= '9') {
+        if (*value > (0xFFFFFFFFUL - (query[*pos] - '0')) / 10) {
+            return 0;
+        }
+        *value = *value * 10 + (query[*pos] - '0');
+        (*pos)++;
+        digits++;
+    }
+    return digits != 0;
+}
+
+/**
+Function Name : parseLogQuery
+
+Description : Collects the cursor and filter of a GET /device/log query, "key=value" pairs separated
+    by '&' up to the space before the protocol. Each key may be given once, in any order:
+
+        since=N         Records with a sequence number of N or higher (0)
+        event=C,C,...   Records with one of these event codes, 1 to 7 (any)
+        from=T          Records stamped at T or later, in RTC seconds (0)
+        to=T            Records stamped at T or earlier (no limit)
+        limit=L         At most L records, 1 to LOG_LIMIT_MAX (LOG_RECORDS_PER_RESPONSE)
+
+    A request line without a query gets the defaults shown (see parseRequestLine); an empty query,
+    or one that is not followed by the space, as when the line was cut short, is rejected.
 
-        //If not a modification to the config values, check for reset, no reset, or invalid request.
+Arguments :
+    (requestState*) state - Receives the cursor in 'value' and the filter in 'log'.
+    (char*) query - The query, just after the '?'.
+    (unsigned char) len - The number of characters in the rest of the request line.
+
+Returns :
+    (unsigned char) - 1 if the query holds valid pairs and nothing else, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char parseLogQuery(requestState* state, char* query, unsigned char len) {
+    unsigned char pos = 0;
+    unsigned char given = 0;
+    unsigned char key;
+    unsigned long value;
+
+    defaultQuery(state);
+    while (1) {
+        //Find the key
+        key = findKey(logKeys, LOG_KEYS, query, len, &pos);
+        if (key == LOG_KEYS || (given & (1 << key))) {
+            return 0;
+        }
+        given |= 1 << key;
+
+        //Its value; the event codes are a list
+        if (key == LOG_KEY_EVENT) {
+            while (1) {
+                if (pos == len || query[pos] < '1' || query[pos] > '0' + EVENT_LO_ALARM) {
+                    return 0;
+                }
+                state->log.events |= 1 << (query[pos] - '0');
+                pos++;
+                if (pos == len || query[pos] != ',') {
+                    break;
+                }
+                pos++;
+            }
         } else {
-            if (socket_recv_compare(s, "?reset=\"true\"")) {
-                requestType = PUT_REQUEST_RESET;
-            } else if (socket_recv_compare(s, "?reset=\"false\"")) {
-                requestType = PUT_REQUEST_NO_RESET;
+            if (!takeNumber(query, len, &pos, &value)) {
+                return 0;
+            }
+            if (key == LOG_KEY_SINCE) {
+                state->value = value;
+            } else if (key == LOG_KEY_FROM) {
+                state->log.from = value;
+            } else if (key == LOG_KEY_TO) {
+                state->log.to = value;
+            } else if (value == 0 || value > LOG_LIMIT_MAX) {
+                return 0;
             } else {
-                requestType = INVALID;
+                state->log.limit = (unsigned char)value;
             }
         }
 
-    //DELTE REQUEST:
-    } else if (socket_recv_compare(s, "DELETE")) {
-        //Check for deletion of the logs or invalid request
-        if (socket_recv_compare(s, " /device/log")) {
-            requestType = DELTE_LOG_REQUEST;
+        //Another pair, or the end of the query
+        if (pos < len && query[pos] == '&') {
+            pos++;
         } else {
-            requestType = INVALID;
+            return pos < len && query[pos] == ' ';
         }
-    //INVALID REQUEST:
-    } else {
-        requestType = INVALID;
     }
+}
 
-    //Used to determine the results of the request
-    unsigned char result;
+/**
+Function Name : writeHeaders
 
-    switch (requestType) {
-        case GET_REQUEST :
-            //Process GET request
-            result = 0;
-            error = 2;
-            buildGetResponse(s);
-            break;
-        case PUT_REQUEST_CRIT_HI :
-            //Process tcrit_hi change
-            result = update_tcrit_hi(value);
-            if (result == 0) {
-                error = 2;
-            } else {
-                error = 4;
-            }
-            buildGeneralResponse(s);
-            break;
-        case PUT_REQUEST_WARN_HI :
-            //Process twarn_hi change
-            result = update_twarn_hi(value);
-            if (result == 0) {
-                error = 2;
-            } else {
-                error = 4;
-            }
-            buildGeneralResponse(s);
-            break;
-        case PUT_REQUEST_CRIT_LO :
-            //Process tcrit_lo change
-            result = update_tcrit_lo(value);
-            if (result == 0) {
-                error = 2;
-            } else {
-                error = 4;
-            }
-            buildGeneralResponse(s);
-            break;
-        case PUT_REQUEST_WARN_LO :
-            //Process twarn_lo change
-            result = update_twarn_lo(value);
-            if (result == 0) {
-                error = 2;
-            } else {
-                error = 4;
-            }
-            buildGeneralResponse(s);
-            break;
-        case PUT_REQUEST_RESET :
-            //Force system restart after sending response
-            error = 2;
-            buildGeneralResponse(s);
-            restart = 1;
-            break;
-        case DELTE_LOG_REQUEST :
-            //Delete current log values
-            error = 2;
-            buildGeneralResponse(s);
-            log_clear();
-            break;
-        case INVALID :
-            //Any invalid entry will return an error 400 response
-            error = 4;
-            buildGeneralResponse(s);
-            break;
+Description : Writes the status line and headers of a response through the response writer. The body
+    length is given in a Content-Length header so the connection can carry further requests; a body
+    of unknown length is instead ended by closing the connection.
+
+Arguments :
+    (requestState*) state - The request state of the connection being answered.
+    (const char*) contentType - The media type of the body, in program memory, or 0 for a response with
+        no body.
+    (unsigned int) length - The number of characters in the body, or RESPCACHE_LENGTH_UNKNOWN.
+
+Returns :
+    void
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - keepAlive is cleared for a body of unknown length.
+**/
+static void writeHeaders(requestState* state, const char* contentType, unsigned int length) {
+    //Write request line
+    strbuf_puts_P(&response, PSTR("HTTP/1.1 "));
+    if (state->error == 2) {
+        strbuf_putdec(&response, 200);
+        strbuf_puts_P(&response, PSTR(" OK" CRLF));
+    } else {
+        strbuf_putdec(&response, 400);
+        strbuf_puts_P(&response, PSTR(" BAD REQUEST" CRLF));
     }
+
+    if (contentType != 0) {
+        strbuf_puts_P(&response, PSTR("Content-Type: "));
+        strbuf_puts_P(&response, contentType);
+        strbuf_puts_P(&response, PSTR(CRLF));
+    }
+    if (length != RESPCACHE_LENGTH_UNKNOWN) {
+        strbuf_puts_P(&response, PSTR("Content-Length: "));
+        strbuf_putdec(&response, length);
+        strbuf_puts_P(&response, PSTR(CRLF));
+    } else {
+        state->keepAlive = 0;
+    }
+    if (!state->keepAlive) {
+        strbuf_puts_P(&response, PSTR("Connection: close" CRLF));
+    }
+
+    strbuf_puts_P(&response, PSTR(CRLF));
 }
 
 /**
@@ -203,7 +1170,10 @@ Function Name : buildGetResponse
 
 Description : Used to build a valid GET response. GET response includes a 200 HTTP response code
     and a JSON representation of the VPD, the config values for the temperature system, and all
-    log entries.
+    log entries. The JSON is kept pre-serialized by the response cache (see respcache.c) and only
+    the parts whose data changed are re-formatted. The response is collected in the response writer
+    and sent in a few large transfers. Each call writes the next RESPONSE_BUDGET characters or so,
+    once the socket has room for them, and the response is complete after as many calls as it needs.
 
 Arguments :
     (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
@@ -214,302 +1184,620 @@ Returns :
 Changes :
     Ethernet - Writes HTTP response information to the Ethernet device.
     Request FSM - Moves the system into the state for writing a 200 response code GET response
-        with all of the system information.
+        with all of the system information, and back out of it once the response is complete.
+    Response cache - The cache is released once the response is complete.
 **/
 void buildGetResponse(SOCKET s) {
-    //Write request line
-    socket_writestr(s, "HTTP/1.1 ");
-    socket_writedec32(s, 200);
-    socket_writestr(s, " OK\n\r");
-
-    //Write json content type
-    socket_writestr(s, "Content-Type: application/vnd.api+json\n\r");
-    socket_writestr(s, CRLF);
-
-    //Write {
-    socket_writechar(s, '{');
-
-    //Write "vpd"   //Write :{
-    socket_writequotedstring(s, "vpd");
-    socket_writestr(s, ":{");
-
-    //Write "model" //Write :   //Write vpd.model in quotes //Write ,
-    socket_writequotedstring(s, "model");
-    socket_writechar(s, ':');
-    socket_writequotedstring(s, vpd.model);
-    socket_writechar(s, ',');
-
-    //Write "manufacturer"  //Write :   //Write vpd.manufacturer in quotes  //Write ,
-    socket_writequotedstring(s, "manufacturer");
-    socket_writechar(s, ':');
-    socket_writequotedstring(s, vpd.manufacturer);
-    socket_writechar(s, ',');
-
-    //Write "serial_number" //Write :   //Write vpd.serial_number   //Write ,
-    socket_writequotedstring(s, "serial_number");
-    socket_writechar(s, ':');
-    socket_writequotedstring(s, vpd.serial_number);
-    socket_writechar(s, ',');
-
-    //Write "manufacturer_date" //Write :   //Write vpd.manufacturer_date in quotes //Write ,
-    socket_writequotedstring(s, "manufacture_date");
-    socket_writechar(s, ':');
-    socket_writedate(s, vpd.manufacture_date);
-    socket_writechar(s, ',');
-
-    //Write "mac_address"   //Write mac accdress (socket.h) function
-    socket_writequotedstring(s, "mac_address");
-    socket_writechar(s, ':');
-    socket_write_macaddress(s, vpd.mac_address);
-    socket_writechar(s, ',');
-
-    //Write "country_code"  //Write :   //Write vpd.country_code in quotes  //Write },
-    socket_writequotedstring(s, "country_code");
-    socket_writechar(s, ':');
-    socket_writequotedstring(s, vpd.country_of_origin);
-    socket_writestr(s, "},");;
-
-    //Write "tcrit_hi" //Write : //Write config.tcrit_hi value //Write ,
-    socket_writequotedstring(s, "tcrit_hi");
-    socket_writechar(s, ':');
-    socket_writedec32(s, config.hi_alarm);
-    socket_writechar(s, ',');
-
-    //Write "twarn_hi" //Write : //Write config.twarn_hi value //Write ,
-    socket_writequotedstring(s, "twarn_hi");
-    socket_writechar(s, ':');
-    socket_writedec32(s, config.hi_warn);
-    socket_writechar(s, ',');
-
-    //Write "tcrit_lo" //Write : //Write config.tcrit_lo value //Write ,
-    socket_writequotedstring(s, "tcrit_lo");
-    socket_writechar(s, ':');
-    socket_writedec32(s, config.lo_alarm);
-    socket_writechar(s, ',');
-
-    //Write "twarn_lo" //Write : //Write config.twarn_lo value //Write ,
-    socket_writequotedstring(s, "twarn_lo");
-    socket_writechar(s, ':');
-    socket_writedec32(s, config.lo_warn);
-    socket_writechar(s, ',');
-
-    //Write "temperature" //Write : //Write config.current_temp value //Write ,
-    socket_writequotedstring(s, "temperature");
-    socket_writechar(s, ':');
-    socket_writedec32(s, temp_get());
-    socket_writechar(s, ',');
-
-    //Write "state" //Write : //Write tempsfm state //Write ,
-    socket_writequotedstring(s, "state");
-    socket_writechar(s, ':');
-    socket_writequotedstring(s, getTempState(temp_get()));
-    socket_writechar(s, ',');
-
-    //Write "log" //Write :[
-    //Write all current logs in format {"timestamp":"date_time","event":X},
-    socket_writequotedstring(s, "log");
-    socket_writestr(s, ":[");
-    unsigned char i;
-    for (i = 0; i < log_get_num_entries(); i++) {
-        unsigned long time = 0;
-        unsigned char event = 0;
-        if (log_get_record(i, &time, &event)) {
-            socket_writechar(s, '{');
-            socket_writequotedstring(s, "timestamp");
-            socket_writechar(s, ':');
-
-            //Write the log entry timestamp here
-            socket_writequotedstring(s, rtc_num2datestr(time));
-
-            socket_writechar(s, ',');
-            socket_writequotedstring(s, "event");
-            socket_writechar(s, ':');
-
-            //Write the log entry event num
-            socket_writedec32(s, event);
-
-            //If there are no more entries, write a '}', otherwise append a ','
-            if (i == log_get_num_entries() - 1) {
-                socket_writechar(s, '}');
-            } else {
-                socket_writestr(s, "},");
-            }
-        }
-    }
+    requestState* state = &connection[s];
 
-    //Write ] to close array
-    socket_writechar(s, ']');
+    //Wait until the socket's transmit buffer can take this pass's share of the response
+    if (socket_send_available(s) < RESPONSE_BUDGET + RESPCACHE_LOG_CHUNK) {
+        return;
+    }
 
-    //Write }
-    socket_writechar(s, '}');
-    socket_writestr(s, CRLF);
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
 
-    //Send response and flag completion
-    processComplete = 1;
+    //Write the status line and headers, then the JSON body from the response cache
+    if (state->part == RESPCACHE_PART_HEADER) {
+        writeHeaders(state, jsonType, state->length);
+        state->part = RESPCACHE_PART_VPD;
+    }
+    if (respcache_write(&response, &state->part, &state->entry, RESPONSE_BUDGET)) {
+        //Send response and flag completion
+        respcache_end();
+        state->phase = PHASE_REQUEST;
+        state->processComplete = !state->keepAlive;
+    }
+    strbuf_flush(&response);
 }
 
 /**
 Function Name : buildGeneralResponse
 
 Description : Used to build a general response. Checks to see if the error code is 200 or 400,
-    then writes the appropriate HTTP response line and CRLF lines.
+    then writes the appropriate HTTP response line and headers through the response writer. The
+    response has no body.
 
 Arguments :
     (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
 
 Returns :
-    void
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
 
 Changes :
     Ethernet - Writes HTTP response information to the Ethernet device.
     Request FSM - Moves the system into the state for writing a general HTTP response. Response code
         types can be 200 or 400 depending on what the error value was assigned for in the previous
         state.
+    Stats - A 400 response is counted.
 **/
-void buildGeneralResponse(SOCKET s) {
-    //Write request line
-    socket_writestr(s, "HTTP/1.1 ");
-    if (error == 2) {
-        socket_writedec32(s, 200);
-        socket_writestr(s, " OK\n\r");
-    } else {
-        socket_writedec32(s, 400);
-        socket_writestr(s, " BAD REQUEST\n\r");
+unsigned char buildGeneralResponse(SOCKET s) {
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX) {
+        return 0;
+    }
+    if (connection[s].error == 4) {
+        stats_count(STATS_BAD_REQUESTS);
+    }
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(&connection[s], 0, 0);
+    strbuf_flush(&response);
+
+    //Send response and flag completion
+    connection[s].processComplete = !connection[s].keepAlive;
+    return 1;
+}
+
+/**
+Function Name : buildStatsResponse
+
+Description : Used to build the response to GET /device/stats: the request counters, EEPROM
+    write-backs and hot-path timers kept by stats.c. The clock readings are taken once, so the body
+    written to count its length and the body sent are the same.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - Flags completion when the connection should be closed.
+**/
+unsigned char buildStatsResponse(SOCKET s) {
+    strbuf counter;
+    unsigned long now = sched_now();
+    unsigned long idle = sched_idle_ms();
+
+    strbuf_init(&counter, 0, 0);
+    stats_write(&counter, now, idle);
+    strbuf_puts_P(&counter, PSTR(CRLF));
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX + counter.len) {
+        return 0;
     }
 
-    socket_writestr(s, CRLF);
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(&connection[s], jsonType, counter.len);
+    stats_write(&response, now, idle);
+    strbuf_puts_P(&response, PSTR(CRLF));
+    strbuf_flush(&response);
 
     //Send response and flag completion
-    processComplete = 1;
+    connection[s].processComplete = !connection[s].keepAlive;
+    return 1;
 }
 
 /**
-Function Name : getTempState
+Function Name : buildBinaryResponse
 
-Description : Takes in the current temperature of the system and compares it to the high and low
-    warning/alarm values. After comparison, returns the state of the system as a char* string.
+Description : Used to build the binary form of the GET response (see binresp.h), for GET /device.bin
+    or a GET /device whose Accept header lists application/octet-stream. It holds the same data as
+    the JSON response in fixed-layout fields and is written in one pass.
 
 Arguments :
-    (int) currentTemp - The current temperature of the system.
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
 
 Returns :
-    (char*) - The current state of the system as a string.
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
 
 Changes :
-    N/A
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - Flags completion when the connection should be closed.
 **/
-char* getTempState(int currentTemp) {
-    char* tempState;
-    //Check current temp to set it to corresponding state
-    if (currentTemp <= config.lo_alarm) {
-        //state = LOW_ALARM;
-        tempState = "LOW_CRITICAL";
-    } else if (currentTemp <= config.lo_warn && currentTemp > config.lo_alarm) {
-        //state = LOW_WARN;
-        tempState = "LOW_WARN";
-    } else if (currentTemp > config.lo_warn && currentTemp < config.hi_warn) {
-        //state = NORMAL;
-        tempState = "NORMAL";
-    } else if (currentTemp >= config.hi_warn && currentTemp < config.hi_alarm) {
-        //state = HIGH_WARN;
-        tempState = "HIGH_WARN";
-    } else {
-        //state = HIGH_ALARM;
-        tempState = "HIGH_CRITICAL";
+unsigned char buildBinaryResponse(SOCKET s) {
+    unsigned int size = binresp_size();
+
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX + size) {
+        return 0;
     }
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(&connection[s], binaryType, size);
+    binresp_write(&response);
+    strbuf_flush(&response);
 
-    //Return the temperature state as a string
-    return tempState;
+    //Send response and flag completion
+    connection[s].processComplete = !connection[s].keepAlive;
+    return 1;
 }
 
 /**
-Function Name : update_tcrit_hi()
+Function Name : findLogStart
 
-Description : Updates the system's hi_alarm value.
+Description : Finds the index of the log record a cursor points at: the oldest record whose sequence
+    number is 'since' or higher. A cursor older than the log points at the oldest record left, and
+    one past the newest record at the end of the log.
 
 Arguments :
-    (int) value - The proposed new value for the system's hi_alarm value.
+    (unsigned long) since - The sequence number of the first record wanted.
 
 Returns :
-    (int) - 0 if new value is okay, otherwise 1.
+    (unsigned char) - The index of the record, or log_get_num_entries() if there is none.
 
 Changes :
     N/A
 **/
-unsigned char update_tcrit_hi(int value) {
-    if (value > config.hi_warn && value < 0x3FF) {
-        config.hi_alarm = value;
+static unsigned char findLogStart(unsigned long since) {
+    unsigned long first = log_get_first_seq();
+    unsigned char total = log_get_num_entries();
+
+    if (since <= first) {
         return 0;
-    } else {
-        return 1;
     }
+    return since - first < total ? (unsigned char)(since - first) : total;
+}
+
+/**
+Function Name : writeLogRecords
+
+Description : Writes the "log" member shared by the GET /device/log and GET /device/events bodies.
+    The log is walked from index 'start', one log_get_record per record, and each record that passes
+    the query's filter is written as it is read, with its sequence number, until the query's limit
+    is reached; a record stamped before the clock was synchronized is marked "provisional". Then
+    come the cursor for the next request, just after the last record walked, and whether records
+    after it are waiting to be walked. Nothing is collected, so the work and the length of the body
+    are bounded by the records walked and the limit.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) start - The index of the first record.
+    (logQuery*) query - The filter and limit.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void writeLogRecords(strbuf* b, unsigned char start, logQuery* query) {
+    unsigned long time = 0;
+    unsigned char event = 0;
+    unsigned char total = log_get_num_entries();
+    unsigned char index;
+    unsigned char count = 0;
+
+    strbuf_putquoted_P(b, PSTR("log"));
+    strbuf_puts_P(b, PSTR(":["));
+    for (index = start; index < total && count < query->limit; index++) {
+        log_get_record(index, &time, &event);
+        if ((query->events != 0 && !(query->events & (1 << event))) || time < query->from || time > query->to) {
+            continue;
+        }
+        if (count != 0) {
+            strbuf_putc(b, ',');
+        }
+        count++;
+        strbuf_putc(b, '{');
+        strbuf_putquoted_P(b, PSTR("seq"));
+        strbuf_putc(b, ':');
+        strbuf_putdec(b, log_get_first_seq() + index);
+        strbuf_putc(b, ',');
+        strbuf_putquoted_P(b, PSTR("timestamp"));
+        strbuf_putc(b, ':');
+        strbuf_putdate(b, time);
+        strbuf_putc(b, ',');
+        strbuf_putquoted_P(b, PSTR("event"));
+        strbuf_putc(b, ':');
+        strbuf_putdec(b, event);
+        if (log_get_provisional()) {
+            strbuf_putc(b, ',');
+            strbuf_putquoted_P(b, PSTR("provisional"));
+            strbuf_puts_P(b, PSTR(":true"));
+        }
+        strbuf_putc(b, '}');
+    }
+    strbuf_puts_P(b, PSTR("],"));
+    strbuf_putquoted_P(b, PSTR("next"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, log_get_first_seq() + index);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("more"));
+    strbuf_putc(b, ':');
+    strbuf_puts_P(b, index < total ? PSTR("true") : PSTR("false"));
 }
 
 /**
-Function Name : update_twarn_hi()
+Function Name : writeLogBody
 
-Description : Updates the system's hi_warn value.
+Description : Writes the JSON body of a GET /device/log response (see writeLogRecords).
 
 Arguments :
-    (int) value - The proposed new value for the system's hi_warn value.
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) start - The index of the first record.
+    (logQuery*) query - The filter and limit.
 
 Returns :
-    (int) - 0 if new value is okay, otherwise 1
+    void
 
 Changes :
     N/A
 **/
-unsigned char update_twarn_hi(int value) {
-    if (value > config.lo_warn && value < config.hi_alarm) {
-        config.hi_warn = value;
+static void writeLogBody(strbuf* b, unsigned char start, logQuery* query) {
+    strbuf_putc(b, '{');
+    writeLogRecords(b, start, query);
+    strbuf_putc(b, '}');
+    strbuf_puts_P(b, PSTR(CRLF));
+}
+
+/**
+Function Name : buildLogResponse
+
+Description : Used to build the response to GET /device/log?since=N&event=...&from=...&to=...&limit=L
+    (see parseLogQuery). Returns the log records whose sequence number is N or higher and that match
+    the filter, at most L of them, and the cursor to pass as 'since' on the next request. A poller
+    that keeps passing the returned cursor pages through the matching records and then only ever
+    receives new ones, so once it has caught up its responses hold no records at all. If records
+    after the cursor have already been dropped from the log, the response starts at the oldest
+    record left, and the gap shows in its sequence number. Without a cursor the log is walked from
+    the oldest record. The body is written twice, first only to count its length.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - Flags completion when the connection should be closed.
+**/
+unsigned char buildLogResponse(SOCKET s) {
+    requestState* state = &connection[s];
+    strbuf counter;
+    unsigned char start = findLogStart((unsigned long)state->value);
+
+    strbuf_init(&counter, 0, 0);
+    writeLogBody(&counter, start, &state->log);
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX + counter.len) {
         return 0;
-    } else {
-        return 1;
     }
+
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(state, jsonType, counter.len);
+    writeLogBody(&response, start, &state->log);
+    strbuf_flush(&response);
+
+    //Send response and flag completion
+    connection[s].processComplete = !connection[s].keepAlive;
+    return 1;
+}
+
+/**
+Function Name : eventsPending
+
+Description : Checks whether a GET /device/events has something to report: a log record at or after
+    its cursor, or a temperature state other than the one the client last saw.
+
+Arguments :
+    (requestState*) state - The request state of the waiting connection.
+
+Returns :
+    (unsigned char) - 1 if the request should be answered now, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char eventsPending(requestState* state) {
+    return findLogStart((unsigned long)state->value) < log_get_num_entries() ||
+           (state->seenState != EVENTS_ANY_STATE && state->seenState != tempfsm_get_state());
 }
 
 /**
-Function Name : update_twarn_lo()
+Function Name : writeEventsBody
 
-Description : Updates the system's lo_warn value.
+Description : Writes the JSON body of a GET /device/events response: the current temperature, its
+    state by name and by code, then the log records after the cursor as GET /device/log returns them.
+    The client passes "next" and "state_code" back as 'since' and 'state' on its next request.
 
 Arguments :
-    (int) value - The proposed new value for the system's lo_warn value.
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) start - The index of the first record.
+    (logQuery*) query - The filter and limit.
 
 Returns :
-    (int) - 0 if new value is okay, otherwise 1
+    void
 
 Changes :
     N/A
 **/
-unsigned char update_twarn_lo(int value) {
-    if (value > config.lo_alarm && value < config.hi_warn) {
-        config.lo_warn = value;
+static void writeEventsBody(strbuf* b, unsigned char start, logQuery* query) {
+    unsigned char tempState = tempfsm_get_state();
+
+    strbuf_putc(b, '{');
+    strbuf_putquoted_P(b, PSTR("temperature"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, tempfsm_get_temperature());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("state"));
+    strbuf_putc(b, ':');
+    strbuf_putquoted_P(b, tempfsm_state_name(tempState));
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("state_code"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, tempState);
+    strbuf_putc(b, ',');
+    writeLogRecords(b, start, query);
+    strbuf_putc(b, '}');
+    strbuf_puts_P(b, PSTR(CRLF));
+}
+
+/**
+Function Name : buildEventsResponse
+
+Description : Used to answer GET /device/events?since=N&state=S, a long poll for what GET /device
+    would show changing. The request is answered once a log record with a sequence number of N or
+    higher exists or the temperature state differs from S (both optional), or after EVENTS_TIMEOUT
+    seconds with nothing new; until then the request FSM holds it open (see requestFSM). A
+    subscriber that keeps passing back the cursor and state it was given therefore hears of every new
+    log record and every state change as soon as the executive reaches its socket, instead of
+    re-reading the whole GET /device document on a timer. The body is written twice, first only to
+    count its length.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - Leaves PHASE_WAIT, restarts the keep-alive timer and flags completion when the
+        connection should be closed.
+**/
+unsigned char buildEventsResponse(SOCKET s) {
+    requestState* state = &connection[s];
+    strbuf counter;
+    unsigned char start = findLogStart((unsigned long)state->value);
+
+    strbuf_init(&counter, 0, 0);
+    writeEventsBody(&counter, start, &state->log);
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX + counter.len) {
         return 0;
-    } else {
-        return 1;
     }
+
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(state, jsonType, counter.len);
+    writeEventsBody(&response, start, &state->log);
+    strbuf_flush(&response);
+
+    //Send response and flag completion; the wait does not count against the keep-alive timeout
+    state->phase = PHASE_REQUEST;
+    state->lastActive = rtc_get_date();
+    state->processComplete = !state->keepAlive;
+    return 1;
 }
 
 /**
-Function Name : update_tcrit_lo()
+Function Name : writeSamplesBody
 
-Description : Updates the system's lo_alarm value.
+Description : Writes the JSON body of a GET /device/samples response: the sampling period, the
+    filter settings, the time of the newest sample, the minimum, maximum and mean over the whole
+    buffer, then 'count' samples starting at index 'start' with the sequence number of the first, and
+    the cursor for the next request. The samples are the raw sensor readings, before the filter.
 
 Arguments :
-    (int) value - The proposed new value for the system's lo_alarm value.
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) start - The index of the first sample.
+    (unsigned char) count - The number of samples.
 
 Returns :
-    (int) - 0 if new value is okay, otherwise 1
+    void
 
 Changes :
     N/A
 **/
-unsigned char update_tcrit_lo(int value) {
-    if (value < config.lo_warn) {
-        config.lo_alarm = value;
+static void writeSamplesBody(strbuf* b, unsigned char start, unsigned char count) {
+    filterSettings filter;
+    unsigned char i;
+
+    filter_get(&filter);
+
+    strbuf_putc(b, '{');
+    strbuf_putquoted_P(b, PSTR("samples"));
+    strbuf_puts_P(b, PSTR(":{"));
+    strbuf_putquoted_P(b, PSTR("period_ms"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, SAMPLES_PERIOD_MS);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("filter"));
+    strbuf_puts_P(b, PSTR(":{"));
+    strbuf_putquoted_P(b, PSTR("median"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, filter.median);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("ema"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, filter.ema);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("slew"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, filter.slew);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("hyst"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, filter.hyst);
+    strbuf_puts_P(b, PSTR("},"));
+    strbuf_putquoted_P(b, PSTR("timestamp"));
+    strbuf_putc(b, ':');
+    strbuf_putdate(b, samples_last_time());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("min"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, samples_min());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("max"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, samples_max());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("mean"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, samples_mean());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("seq"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, samples_first_seq() + start);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("values"));
+    strbuf_puts_P(b, PSTR(":["));
+    for (i = 0; i < count; i++) {
+        if (i != 0) {
+            strbuf_putc(b, ',');
+        }
+        strbuf_putdec(b, samples_get(start + i));
+    }
+    strbuf_puts_P(b, PSTR("]},"));
+    strbuf_putquoted_P(b, PSTR("next"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, samples_first_seq() + start + count);
+    strbuf_putc(b, '}');
+    strbuf_puts_P(b, PSTR(CRLF));
+}
+
+/**
+Function Name : buildSamplesResponse
+
+Description : Used to build the response to GET /device/samples?since=N. Returns the buffered
+    temperature samples whose sequence number is N or higher, oldest first, with the aggregates over
+    the whole buffer and the cursor to pass as 'since' on the next request, in the manner of
+    GET /device/log. Without a cursor every buffered sample is returned. A poller that asks at least
+    once every SAMPLES_SIZE samples receives every sample exactly once; if it falls further behind,
+    the gap shows in the sequence number of the first value. The body is written twice, first only
+    to count its length.
+
+Arguments :
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to connect to.
+    (unsigned long) since - The sequence number of the first sample wanted.
+
+Returns :
+    (unsigned char) - 1 if the response was written, or 0 if the socket had no room for it.
+
+Changes :
+    Ethernet - Writes HTTP response information to the Ethernet device.
+    Request FSM - Flags completion when the connection should be closed.
+**/
+unsigned char buildSamplesResponse(SOCKET s, unsigned long since) {
+    strbuf counter;
+    unsigned long first = samples_first_seq();
+    unsigned char total = samples_count();
+    unsigned char start = 0;
+
+    //Find the sample the cursor points at
+    if (since > first) {
+        start = since - first < total ? (unsigned char)(since - first) : total;
+    }
+
+    strbuf_init(&counter, 0, 0);
+    writeSamplesBody(&counter, start, total - start);
+    if (socket_send_available(s) < RESPONSE_HEADERS_MAX + counter.len) {
         return 0;
-    } else {
+    }
+
+    strbuf_init_socket(&response, responseData, RESPONSE_BUF_SIZE, s);
+    writeHeaders(&connection[s], jsonType, counter.len);
+    writeSamplesBody(&response, start, total - start);
+    strbuf_flush(&response);
+
+    //Send response and flag completion
+    connection[s].processComplete = !connection[s].keepAlive;
+    return 1;
+}
+
+/**
+Function Name : takeFilterSetting
+
+Description : Copies one filter setting from a config PUT, if it was given, into a settings struct.
+
+Arguments :
+    (unsigned char*) setting - The field of the settings struct.
+    (int*) values - The proposed settings, indexed by CONFIG_ index.
+    (unsigned char) mask - Bit (1 << index) set for each setting given in 'values'.
+    (unsigned char) index - The CONFIG_FILT_ index of the setting.
+
+Returns :
+    (unsigned char) - 1 if the value given does not fit the field, otherwise 0.
+
+Changes :
+    N/A
+**/
+static unsigned char takeFilterSetting(unsigned char* setting, int* values, unsigned char mask, unsigned char index) {
+    if (mask & (1 << index)) {
+        if (values[index] < 0 || values[index] > 0xFF) {
+            return 1;
+        }
+        *setting = (unsigned char)values[index];
+    }
+    return 0;
+}
+
+/**
+Function Name : update_config()
+
+Description : Updates any subset of the system's thresholds and filter settings in one step. The
+    settings that are not given keep their values, and the resulting thresholds must keep the band
+    order lo_alarm < lo_warn < hi_warn < hi_alarm < 0x3FF and the filter settings must be in range
+    (see filter_check); otherwise nothing is changed. Checking the set as a whole lets a client move
+    the entire band in one request, where single-threshold updates would have to be ordered so that
+    each intermediate band is valid.
+
+Arguments :
+    (int*) values - The proposed settings, indexed by CONFIG_ index.
+    (unsigned char) mask - Bit (1 << index) set for each setting given in 'values'.
+
+Returns :
+    (unsigned char) - 0 if the new settings are okay and were applied, otherwise 1.
+
+Changes :
+    Config - The given thresholds are set together.
+    Temp FSM - The last temperature sample is reclassified under the new thresholds.
+    Filter - The filter settings are replaced and the filter restarted if one changed.
+    Response cache - The config segment is invalidated if a threshold changed.
+    Write-back - A change is queued for write-back to EEPROM, once for the whole set.
+**/
+unsigned char update_config(int* values, unsigned char mask) {
+    int hiAlarm = (mask & (1 << CONFIG_CRIT_HI)) ? values[CONFIG_CRIT_HI] : config.hi_alarm;
+    int hiWarn = (mask & (1 << CONFIG_WARN_HI)) ? values[CONFIG_WARN_HI] : config.hi_warn;
+    int loWarn = (mask & (1 << CONFIG_WARN_LO)) ? values[CONFIG_WARN_LO] : config.lo_warn;
+    int loAlarm = (mask & (1 << CONFIG_CRIT_LO)) ? values[CONFIG_CRIT_LO] : config.lo_alarm;
+    filterSettings filter;
+
+    filter_get(&filter);
+    if (CONFIG_FILTER_TABLE(TAKE_FILTER_SETTING) filter_check(&filter)) {
         return 1;
     }
+    if (mask == 0 || !(loAlarm < loWarn && loWarn < hiWarn && hiWarn < hiAlarm && hiAlarm < 0x3FF)) {
+        return 1;
+    }
+    if (hiAlarm != config.hi_alarm || hiWarn != config.hi_warn ||
+            loWarn != config.lo_warn || loAlarm != config.lo_alarm) {
+        config.hi_alarm = hiAlarm;
+        config.hi_warn = hiWarn;
+        config.lo_warn = loWarn;
+        config.lo_alarm = loAlarm;
+        tempfsm_set_thresholds(hiAlarm, hiWarn, loAlarm, loWarn);
+        respcache_invalidate_config();
+        writeback_config_changed();
+    }
+    if (filter_set(&filter)) {
+        writeback_filter_changed();
+    }
+    return 0;
 }
@@ -13,23 +13,110 @@ Description : Header file for parser.c; contains all variables and functions to
     in files that include this header.
 **/
 
+//DEFINES:
+#define SERVER_SOCKETS 3    //W5x sockets 0..2 serve HTTP; socket 3 is left to DHCP, NTP and alarms
+//Settings a config PUT can set: X(index, key, field). 'key' is both the query key of PUT
+//  /device/config and the member name in the GET /device document; 'field' is the member of
+//  'config' (thresholds) or of filterSettings (filter) that holds the setting. The thresholds are
+//  listed in the order GET /device shows them. Each table is expanded where it is needed; adding a
+//  row adds the key to the query parser, the document and the CONFIG_ index together.
+#define CONFIG_THRESHOLD_TABLE(X) \
+    X(CONFIG_CRIT_HI,       tcrit_hi,       hi_alarm) \
+    X(CONFIG_WARN_HI,       twarn_hi,       hi_warn) \
+    X(CONFIG_CRIT_LO,       tcrit_lo,       lo_alarm) \
+    X(CONFIG_WARN_LO,       twarn_lo,       lo_warn)
+#define CONFIG_FILTER_TABLE(X) \
+    X(CONFIG_FILT_MEDIAN,   filt_median,    median) \
+    X(CONFIG_FILT_EMA,      filt_ema,       ema) \
+    X(CONFIG_FILT_SLEW,     filt_slew,      slew) \
+    X(CONFIG_FILT_HYST,     filt_hyst,      hyst)
+#define CONFIG_INDEX(index, key, field) index,
+#define CONFIG_DIGITS_MAX 5     //Digits of a config value; a '-' may come before them
+#define CONFIG_VALUE_MAX 0x7FFF //Largest magnitude of a config value, the most a 16-bit int holds
+#define CONFIG_PAIR_MAX(index, key, field) + sizeof(#key "=") + CONFIG_DIGITS_MAX + 1
+//Received characters buffered for parsing; a longer request line is answered 400 unparsed. Fits
+//  the longest config PUT: every setting, each with a sign and CONFIG_DIGITS_MAX digits ('&'
+//  between the pairs takes the place of each key's terminating NUL), then the protocol and CRLF
+#define REQUEST_LINE_MAX (sizeof("PUT /device/config?") - 1 \
+    CONFIG_THRESHOLD_TABLE(CONFIG_PAIR_MAX) CONFIG_FILTER_TABLE(CONFIG_PAIR_MAX) - 1 + sizeof(" HTTP/1.1\r\n") - 1)
+#define KEEPALIVE_TIMEOUT 10    //Seconds an idle persistent connection is kept open
+#define EVENTS_TIMEOUT 25   //Seconds a GET /device/events waits for news before answering without any
+#define EVENTS_ANY_STATE 0xFF   //No temperature state given to GET /device/events
+#define PHASE_REQUEST 0     //Receiving the request line
+#define PHASE_RESPONSE 1    //Writing a GET response over several passes
+#define PHASE_HEADERS 2     //Receiving the request headers
+#define PHASE_BODY 3        //Discarding the request body
+#define PHASE_WAIT 4        //Holding a GET /device/events until there is something to report
+#define PHASE_ANSWER 5      //Holding a complete request until the socket has room for its response
+#define FSM_IDLE 0          //requestFSM found nothing to do
+#define FSM_BUSY 1          //requestFSM received or wrote data
+#define FSM_DISPATCHED 2    //requestFSM handled a complete request
+
 //DECLARATIONS:
-unsigned char requestType;
-unsigned char processComplete;
+//Index of each setting in requestState.config, thresholds first
+enum {CONFIG_THRESHOLD_TABLE(CONFIG_INDEX) CONFIG_FILTER_TABLE(CONFIG_INDEX) CONFIG_FIELDS};
+
+//Which log records a GET /device/log or GET /device/events returns
+typedef struct {
+    unsigned char events;           //Bit (1 << code) set for each event code wanted, 0 for every code
+    unsigned char limit;            //Most records returned
+    unsigned long from;             //Earliest timestamp returned
+    unsigned long to;               //Latest timestamp returned
+} logQuery;
+
+//State of the connection on one server socket
+typedef struct {
+    unsigned char requestType;      //Request code from the request line
+    unsigned char processComplete;  //Set once the connection should be closed
+    unsigned char error;            //2 for a 200 response, 4 for a 400 response
+    unsigned char phase;            //PHASE_REQUEST, PHASE_HEADERS, PHASE_BODY or PHASE_RESPONSE
+    unsigned char skipLine;         //Discarding the rest of a truncated line
+    unsigned char keepAlive;        //Keep the connection open after the response
+    unsigned char connected;        //Data has been received on this connection
+    unsigned char binary;           //The client accepts the binary GET /device response
+    long value;                     //Log or samples cursor from the request line
+    logQuery log;                   //Filter and limit of a log or events request
+    unsigned char seenState;        //Temperature state a GET /device/events client last saw
+    int config[CONFIG_FIELDS];      //Settings from a config PUT, by CONFIG_ index
+    unsigned char configMask;       //Bit (1 << index) set for each setting in 'config'
+    unsigned int bodyLeft;          //Request body characters still to discard
+    unsigned int length;            //Content-Length of the GET response body
+    unsigned long lastActive;       //rtc_get_date() when data was last received
+    unsigned char part;             //Response cursor: next part of the GET response
+    unsigned char entry;            //Response cursor: next log record when streaming the log
+} requestState;
+
+//Received characters not yet parsed, shared by the server sockets (see requestFSM)
+typedef struct {
+    unsigned char owner;            //Server socket the characters came from; only meaningful while len > 0
+    unsigned char len;
+    char data[REQUEST_LINE_MAX];    //The rest of a line, or of several pipelined requests
+} lineBuffer;
+
+requestState connection[SERVER_SOCKETS];    //Indexed by server socket
+lineBuffer requestLine;
 unsigned char restart;
 
-void requestFSM(SOCKET s);  //FSM to receive and handle HTTP requests
+unsigned char requestFSM(SOCKET s);     //FSM to receive and handle HTTP requests, one bounded step per call
+
+void resetRequestState(SOCKET s);   //Forget the connection on a socket once it has been disconnected
+
+unsigned char parseRequestLine(char* line, unsigned char len, requestState* state);  //Match a request line against the route trie
+
+void parseHeaderLine(requestState* state, char* line, unsigned char len);   //Pick the framing headers out of a header line
 
 void buildGetResponse(SOCKET s);    //Entered from the request FSM, used to build a GET response
 
-void buildGeneralResponse(SOCKET s);    //Entered from the request FSM, used to build a response for other requests
+unsigned char buildGeneralResponse(SOCKET s);    //Entered from the request FSM, used to build a response for other requests
+
+unsigned char buildBinaryResponse(SOCKET s);     //Entered from the request FSM, used to build a binary GET response
 
-char* getTempState(int currentTemp);    //Set the system's current temperature state and return it as a string.
+unsigned char buildLogResponse(SOCKET s);    //Entered from the request FSM, used to build a GET /device/log response
 
-unsigned char update_tcrit_hi(int value);   //Update the config.tcrit_hi value
+unsigned char buildSamplesResponse(SOCKET s, unsigned long since);   //Entered from the request FSM, used to build a GET /device/samples response
 
-unsigned char update_twarn_hi(int value);   //Update the config.twarn_hi value
+unsigned char buildEventsResponse(SOCKET s);     //Entered from the request FSM, used to answer a GET /device/events
 
-unsigned char update_twarn_lo(int value);   //Update the config.twarn_lo value
+unsigned char buildStatsResponse(SOCKET s);  //Entered from the request FSM, used to build a GET /device/stats response
 
-unsigned char update_tcrit_lo(int value);   //Update the config.tcrit_lo value
+unsigned char update_config(int* values, unsigned char mask);   //Update any subset of the thresholds and filter settings together
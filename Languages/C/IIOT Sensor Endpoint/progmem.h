@@ -0,0 +1,49 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Program memory access for constant tables. On the AVR a table marked PROGMEM stays in
+    flash instead of being copied into SRAM at start-up, and must be read back with the pgm_read_
+    macros. A literal written PSTR("...") is kept in flash the same way, and is passed to the _P
+    functions of strbuf.h. Elsewhere (the host simulator) the marks compile away and the reads are
+    plain loads.
+**/
+#ifndef PROGMEM_H_INCLUDED
+#define PROGMEM_H_INCLUDED
+
+#ifdef __AVR__
+//INCLUDES:
+#include <avr/pgmspace.h>
+
+//DEFINES:
+#ifndef pgm_read_ptr
+#define pgm_read_ptr(addr) ((void*)pgm_read_word(addr))     //Older avr-libc lacks it; pointers are 16 bits
+#endif
+#elif defined(PROGMEM_SECTIONS)
+//DEFINES:
+//Host build for the size report (make size in sim/): flash data goes in .progmem sections as on the
+//  AVR, so it can be told apart from the constants the AVR would copy into SRAM
+#define PROGMEM __attribute__((section(".progmem.data")))
+#define PSTR(s) (__extension__({static const char pstr[] PROGMEM = (s); &pstr[0];}))
+#define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+#define pgm_read_word(addr) (*(const unsigned int*)(addr))
+#define pgm_read_dword(addr) (*(const unsigned long*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#else
+//DEFINES:
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+#define pgm_read_word(addr) (*(const unsigned int*)(addr))
+#define pgm_read_dword(addr) (*(const unsigned long*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#endif
+
+#endif
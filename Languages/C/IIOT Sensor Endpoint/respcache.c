@@ -0,0 +1,508 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Cache for the GET /device response. The JSON document is kept pre-serialized in RAM
+    as three segments: the config thresholds, the temperature and state, and the log array. A segment
+    is only re-serialized when the data behind it changes, so a GET is normally the status line and
+    headers, the VPD block, and three block copies into the response writer.
+
+    The VPD block is the exception: it is not serialized once at boot and kept, although it never
+    changes while running. At close to 200 characters it is the largest part of the document, and a
+    RAM copy did not fit in the atmega328p's 2 KB of SRAM beside the line buffer and the response
+    writer (see "make size" in sim/). Flash cannot be written at run time, and a copy in EEPROM
+    would have to be written at boot and read back byte by byte on every GET, which costs about as
+    much as formatting it. So the block is formatted from the vpd structure, already in RAM, into
+    the response writer on every GET (see writeVpd), and only its length is measured at boot, so the
+    response's Content-Length is still known before it starts.
+
+    The config segment is invalidated by update_config. The temperature segment is rebuilt when the
+    temperature FSM's last sample or its state changes (a config change reclassifies the sample). The log
+    segment is rebuilt when the log's signature (entry count, first and last record) changes, which
+    covers log_add_record and log_clear from anywhere, including the temperature FSM. A log too large
+    for its segment is streamed into the response writer record by record instead. The segment is
+    only sized for a short log, such as the records of a fresh start: the log of a device that has
+    been running a while is streamed whatever the size, so a larger segment would hold RAM for
+    nothing most of the time.
+
+    Responses carry a Content-Length computed when they start, so the segments must not change while
+    a response is being written over several passes. respcache_begin and respcache_end count the
+    responses in progress, and the cache is only refreshed when none are; a GET that starts while
+    another is still being written is served the same snapshot.
+**/
+
+//INCLUDES:
+#include "vpd.h"
+#include "log.h"
+#include "config.h"
+#include "socket.h"
+#include "parser.h"
+#include "tempfsm.h"
+#include "rtc.h"
+#include "strbuf.h"
+#include "respcache.h"
+#include "progmem.h"
+
+//DEFINES:
+#define CRLF "\r\n"
+#define LOG_ENTRY_MAX 66
+#define PUT_THRESHOLD(index, key, field) \
+    strbuf_puts_P(&b, PSTR("\"" #key "\":")); \
+    strbuf_putdec(&b, config.field); \
+    strbuf_putc(&b, ',');
+
+//DECLARATIONS:
+static char configSeg[RESPCACHE_CONFIG_SIZE];
+static char tempSeg[RESPCACHE_TEMP_SIZE];
+static char logSeg[RESPCACHE_LOG_SIZE];
+static unsigned int vpdLen;
+static unsigned int configLen;
+static unsigned int tempLen;
+static unsigned int logLen;
+
+static unsigned char configValid;
+static unsigned char tempValid;
+static unsigned char logValid;     //Log segment holds the whole log
+static unsigned char logStale;     //Log segment must be rebuilt on the next refresh
+static int cachedTemp;
+static unsigned char cachedState;
+static unsigned char readers;      //GET responses being written from the segments
+
+//Log signature the log segment was built from
+static unsigned char logCount;
+static unsigned long logFirstTime;
+static unsigned char logFirstEvent;
+static unsigned long logLastTime;
+static unsigned char logLastEvent;
+
+/**
+Function Name : writeVpd
+
+Description : Formats the VPD block, the start of the GET /device document.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void writeVpd(strbuf* b) {
+    strbuf_putc(b, '{');
+    strbuf_putquoted_P(b, PSTR("vpd"));
+    strbuf_puts_P(b, PSTR(":{"));
+    strbuf_putquoted_P(b, PSTR("model"));
+    strbuf_putc(b, ':');
+    strbuf_putquoted(b, vpd.model);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("manufacturer"));
+    strbuf_putc(b, ':');
+    strbuf_putquoted(b, vpd.manufacturer);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("serial_number"));
+    strbuf_putc(b, ':');
+    strbuf_putquoted(b, vpd.serial_number);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("manufacture_date"));
+    strbuf_putc(b, ':');
+    strbuf_putdate(b, vpd.manufacture_date);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("mac_address"));
+    strbuf_putc(b, ':');
+    strbuf_putmac(b, vpd.mac_address);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("country_code"));
+    strbuf_putc(b, ':');
+    strbuf_putquoted(b, vpd.country_of_origin);
+    strbuf_puts_P(b, PSTR("},"));
+}
+
+/**
+Function Name : respcache_init
+
+Description : Measures the VPD block, which never changes while running, by formatting it into a
+    counting buffer, and marks the segments stale. Must be called after vpd_init().
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Response cache - The length of the VPD block is set and all segments are invalidated.
+**/
+void respcache_init(void) {
+    strbuf b;
+
+    strbuf_init(&b, 0, 0);
+    writeVpd(&b);
+    vpdLen = b.len;
+
+    configValid = 0;
+    tempValid = 0;
+    logValid = 0;
+    logStale = 1;
+}
+
+/**
+Function Name : respcache_invalidate_config
+
+Description : Marks the config segment as stale. The state in the temperature segment follows the
+    temperature FSM, which reclassifies its sample when the thresholds change.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Response cache - The config segment is rebuilt on the next GET.
+**/
+void respcache_invalidate_config(void) {
+    configValid = 0;
+}
+
+/**
+Function Name : buildConfigSegment
+
+Description : Serializes the config thresholds, one member per row of CONFIG_THRESHOLD_TABLE (see
+    parser.h), named by the row's query key.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Response cache - The config segment is rebuilt and marked valid.
+**/
+static void buildConfigSegment(void) {
+    strbuf b;
+    strbuf_init(&b, configSeg, RESPCACHE_CONFIG_SIZE);
+
+    CONFIG_THRESHOLD_TABLE(PUT_THRESHOLD)
+
+    configLen = b.len;
+    configValid = 1;
+}
+
+/**
+Function Name : buildTempSegment
+
+Description : Serializes the temperature and the name of its state.
+
+Arguments :
+    (int) temperature - The temperature FSM's last sample.
+    (unsigned char) state - The TEMP_ state of the sample.
+
+Returns :
+    void
+
+Changes :
+    Response cache - The temperature segment is rebuilt and marked valid.
+**/
+static void buildTempSegment(int temperature, unsigned char state) {
+    strbuf b;
+    strbuf_init(&b, tempSeg, RESPCACHE_TEMP_SIZE);
+
+    strbuf_putquoted_P(&b, PSTR("temperature"));
+    strbuf_putc(&b, ':');
+    strbuf_putdec(&b, temperature);
+    strbuf_putc(&b, ',');
+    strbuf_putquoted_P(&b, PSTR("state"));
+    strbuf_putc(&b, ':');
+    strbuf_putquoted_P(&b, tempfsm_state_name(state));
+    strbuf_putc(&b, ',');
+
+    tempLen = b.len;
+    cachedTemp = temperature;
+    cachedState = state;
+    tempValid = 1;
+}
+
+/**
+Function Name : logChanged
+
+Description : Compares the log's current signature against the one the log segment was built from,
+    and records the new signature.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - 1 if the log may have changed since the segment was built, otherwise 0.
+
+Changes :
+    Response cache - The stored log signature is updated.
+**/
+static unsigned char logChanged(void) {
+    unsigned char count = log_get_num_entries();
+    unsigned long firstTime = 0;
+    unsigned char firstEvent = 0;
+    unsigned long lastTime = 0;
+    unsigned char lastEvent = 0;
+    unsigned char changed;
+
+    if (count > 0) {
+        log_get_record(0, &firstTime, &firstEvent);
+        log_get_record(count - 1, &lastTime, &lastEvent);
+    }
+    changed = count != logCount || firstTime != logFirstTime || firstEvent != logFirstEvent ||
+        lastTime != logLastTime || lastEvent != logLastEvent;
+
+    logCount = count;
+    logFirstTime = firstTime;
+    logFirstEvent = firstEvent;
+    logLastTime = lastTime;
+    logLastEvent = lastEvent;
+    return changed;
+}
+
+/**
+Function Name : writeLogEntry
+
+Description : Formats one log record as a JSON object, preceded by a comma unless it is the first.
+    A record stamped before the clock was synchronized is marked "provisional":true.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) index - The index of the log record.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void writeLogEntry(strbuf* b, unsigned char index) {
+    unsigned long time = 0;
+    unsigned char event = 0;
+
+    if (log_get_record(index, &time, &event)) {
+        if (index != 0) {
+            strbuf_putc(b, ',');
+        }
+        strbuf_putc(b, '{');
+        strbuf_putquoted_P(b, PSTR("timestamp"));
+        strbuf_putc(b, ':');
+        strbuf_putdate(b, time);
+        strbuf_putc(b, ',');
+        strbuf_putquoted_P(b, PSTR("event"));
+        strbuf_putc(b, ':');
+        strbuf_putdec(b, event);
+        if (log_get_provisional()) {
+            strbuf_putc(b, ',');
+            strbuf_putquoted_P(b, PSTR("provisional"));
+            strbuf_puts_P(b, PSTR(":true"));
+        }
+        strbuf_putc(b, '}');
+    }
+}
+
+/**
+Function Name : buildLogSegment
+
+Description : Serializes the log array. If it does not fit in the segment, the segment is left
+    invalid and the log is streamed record by record instead.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Response cache - The log segment is rebuilt, and marked valid if it fit.
+**/
+static void buildLogSegment(void) {
+    strbuf b;
+    unsigned char i;
+    unsigned char count = log_get_num_entries();
+
+    strbuf_init(&b, logSeg, RESPCACHE_LOG_SIZE);
+    strbuf_putquoted_P(&b, PSTR("log"));
+    strbuf_puts_P(&b, PSTR(":["));
+    for (i = 0; i < count && !b.overflow; i++) {
+        writeLogEntry(&b, i);
+    }
+    strbuf_puts_P(&b, PSTR("]}"));
+    strbuf_puts_P(&b, PSTR(CRLF));
+
+    logLen = b.len;
+    logValid = !b.overflow;
+}
+
+/**
+Function Name : respcache_begin
+
+Description : Called at the start of each GET response. Rebuilds every segment whose data has
+    changed since it was serialized, unless another response is still being written from them, and
+    returns the length of the response body.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned int) - The number of characters in the body, or RESPCACHE_LENGTH_UNKNOWN when the log
+        is too large for its segment and is streamed.
+
+Changes :
+    Response cache - Stale config, temperature and log segments are rebuilt, and the segments are
+        held until respcache_end is called.
+**/
+unsigned int respcache_begin(void) {
+    int temperature;
+    unsigned char state;
+
+    if (readers == 0) {
+        temperature = tempfsm_get_temperature();
+        state = tempfsm_get_state();
+        if (!configValid) {
+            buildConfigSegment();
+        }
+        if (!tempValid || temperature != cachedTemp || state != cachedState) {
+            buildTempSegment(temperature, state);
+        }
+        if (logChanged() || logStale) {
+            buildLogSegment();
+            logStale = 0;
+        }
+    }
+    readers++;
+
+    if (!logValid) {
+        return RESPCACHE_LENGTH_UNKNOWN;
+    }
+    return vpdLen + configLen + tempLen + logLen;
+}
+
+/**
+Function Name : respcache_end
+
+Description : Releases the segments held by a GET response once it is complete or abandoned.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Response cache - The segments may be refreshed again once no response holds them.
+**/
+void respcache_end(void) {
+    if (readers > 0) {
+        readers--;
+    }
+}
+
+/**
+Function Name : partSize
+
+Description : Returns the number of characters a response part will take, or an upper bound for a
+    streamed log chunk.
+
+Arguments :
+    (unsigned char) part - The response part.
+
+Returns :
+    (unsigned int) - The size of the part in characters.
+
+Changes :
+    N/A
+**/
+static unsigned int partSize(unsigned char part) {
+    switch (part) {
+        case RESPCACHE_PART_VPD :
+            return vpdLen;
+        case RESPCACHE_PART_CONFIG :
+            return configLen;
+        case RESPCACHE_PART_TEMP :
+            return tempLen;
+        default :
+            return logValid ? logLen : RESPCACHE_LOG_CHUNK;
+    }
+}
+
+/**
+Function Name : respcache_write
+
+Description : Writes the body of the GET /device response through the response writer, resuming at the
+    part and log record held in the caller's cursor. Whole parts are written while they fit in 'budget'
+    characters (at least one part is always written), so the work per call is bounded and a response
+    can be spread over several passes of the cyclic executive. A log that is too large for its segment
+    is streamed record by record, resuming at the saved record index.
+
+Arguments :
+    (strbuf*) out - The response writer, attached to the socket being answered.
+    (unsigned char*) part - Cursor: the next part to write, RESPCACHE_PART_VPD for a new body.
+    (unsigned char*) entry - Cursor: the next log record when streaming the log, 0 for a new response.
+    (unsigned int) budget - Soft limit on the characters written by this call.
+
+Returns :
+    (unsigned char) - 1 once the whole body has been written, otherwise 0.
+
+Changes :
+    Ethernet - Writes the HTTP response through the response writer.
+**/
+unsigned char respcache_write(strbuf* out, unsigned char* part, unsigned char* entry, unsigned int budget) {
+    unsigned int used = 0;
+
+    while (*part != RESPCACHE_PART_DONE) {
+        unsigned int size = partSize(*part);
+        if (used > 0 && used + size > budget) {
+            return 0;
+        }
+        used += size;
+
+        switch (*part) {
+            case RESPCACHE_PART_VPD :
+                writeVpd(out);
+                break;
+            case RESPCACHE_PART_CONFIG :
+                strbuf_putbuf(out, configSeg, configLen);
+                break;
+            case RESPCACHE_PART_TEMP :
+                strbuf_putbuf(out, tempSeg, tempLen);
+                break;
+            default :
+                //Cached log, unless a stream of it is already under way
+                if (logValid && *entry == 0) {
+                    strbuf_putbuf(out, logSeg, logLen);
+                    break;
+                }
+
+                //Streamed log: up to RESPCACHE_LOG_CHUNK characters of records per call
+                if (*entry == 0) {
+                    strbuf_putquoted_P(out, PSTR("log"));
+                    strbuf_puts_P(out, PSTR(":["));
+                }
+                size = 0;
+                while (*entry < log_get_num_entries() && size + LOG_ENTRY_MAX <= RESPCACHE_LOG_CHUNK) {
+                    writeLogEntry(out, *entry);
+                    (*entry)++;
+                    size += LOG_ENTRY_MAX;
+                }
+                if (*entry < log_get_num_entries()) {
+                    return 0;
+                }
+                strbuf_puts_P(out, PSTR("]}"));
+                strbuf_puts_P(out, PSTR(CRLF));
+                break;
+        }
+        (*part)++;
+    }
+    return 1;
+}
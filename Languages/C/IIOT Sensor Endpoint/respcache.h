@@ -0,0 +1,46 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for respcache.c; the pre-serialized GET /device response. Requires strbuf.h.
+**/
+#ifndef RESPCACHE_H_INCLUDED
+#define RESPCACHE_H_INCLUDED
+
+//DEFINES:
+#define RESPCACHE_CONFIG_SIZE   80      /* "tcrit_hi":N,...,"twarn_lo":N, */
+#define RESPCACHE_TEMP_SIZE     48      /* "temperature":N,"state":"...", */
+#ifndef RESPCACHE_LOG_SIZE
+#define RESPCACHE_LOG_SIZE      192     /* "log":[...]} of a short log; a longer one is streamed */
+#endif
+#define RESPCACHE_LOG_CHUNK     256     /* most characters of log records streamed per call; the largest part */
+
+#define RESPCACHE_LENGTH_UNKNOWN 0xFFFF   /* body length when the log is streamed */
+
+//Parts of the GET /device response, in the order they are written
+#define RESPCACHE_PART_HEADER   0       /* status line and headers, written by the caller */
+#define RESPCACHE_PART_VPD      1
+#define RESPCACHE_PART_CONFIG   2
+#define RESPCACHE_PART_TEMP     3
+#define RESPCACHE_PART_LOG      4
+#define RESPCACHE_PART_DONE     5
+
+//DECLARATIONS:
+void respcache_init(void);  //Measure the VPD block and mark the segments stale
+
+void respcache_invalidate_config(void);    //Config thresholds changed
+
+unsigned int respcache_begin(void);     //Start a GET response: refresh the cache and return the body length
+
+void respcache_end(void);   //A GET response started with respcache_begin is complete
+
+unsigned char respcache_write(strbuf* out, unsigned char* part, unsigned char* entry, unsigned int budget);  //Write the next parts of the GET /device response
+
+#endif
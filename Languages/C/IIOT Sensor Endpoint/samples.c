@@ -0,0 +1,297 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Ring buffer of the last SAMPLES_SIZE temperature samples. A client that wants a trend
+    used to poll GET /device for one reading at a time; GET /device/samples returns the buffer, and a
+    client passing the returned cursor back receives each sample once, so polling every few seconds
+    loses nothing.
+
+    The aggregates over the buffer are kept up to date as samples are added, at a fixed cost per
+    sample rather than a pass over the buffer. The mean comes from a running sum: the new sample is
+    added and the one it replaces subtracted. The minimum and maximum each come from a monotonic
+    queue of buffer slots: the minimum queue holds, oldest first, the samples that are lower than
+    every sample after them, so its front is the minimum of the buffer. A new sample removes the
+    queued samples that are not lower than it from the back before it is queued, and the front is
+    removed when its slot is overwritten. Each sample is queued and removed at most once, so a sample
+    costs at most a few queue operations on average.
+**/
+
+//INCLUDES:
+#include "rtc.h"
+#include "samples.h"
+
+//DEFINES:
+#define SAMPLES_MASK (SAMPLES_SIZE - 1)
+
+//DECLARATIONS:
+//Queue of buffer slots whose samples are ordered, front first
+typedef struct {
+    unsigned char slot[SAMPLES_SIZE];
+    unsigned char head;     //Index in 'slot' of the front
+    unsigned char len;
+} slotQueue;
+
+static int ring[SAMPLES_SIZE];
+static unsigned char next;          //Slot the next sample is written to
+static unsigned char count;
+static unsigned long added;         //Samples added since init; the sequence number of the next one
+static unsigned long lastTime;
+static long sum;
+static slotQueue minQueue;          //Front is the slot of the minimum
+static slotQueue maxQueue;          //Front is the slot of the maximum
+
+/**
+Function Name : queuePush
+
+Description : Queues a buffer slot, first removing from the back every queued slot whose sample
+    does not come before the new one in the queue's order. For the minimum queue a sample comes
+    before another if it is lower, for the maximum queue if it is higher.
+
+Arguments :
+    (slotQueue*) q - The queue.
+    (unsigned char) slot - The slot of the new sample, which is already in the buffer.
+    (unsigned char) highFirst - 1 for the maximum queue, 0 for the minimum queue.
+
+Returns :
+    void
+
+Changes :
+    Samples - The queue is updated.
+**/
+static void queuePush(slotQueue* q, unsigned char slot, unsigned char highFirst) {
+    int value = ring[slot];
+    int back;
+
+    while (q->len > 0) {
+        back = ring[q->slot[(q->head + q->len - 1) & SAMPLES_MASK]];
+        if (highFirst ? back > value : back < value) {
+            break;
+        }
+        q->len--;
+    }
+    q->slot[(q->head + q->len) & SAMPLES_MASK] = slot;
+    q->len++;
+}
+
+/**
+Function Name : queueDrop
+
+Description : Removes the front of a queue if it is the slot about to be overwritten.
+
+Arguments :
+    (slotQueue*) q - The queue.
+    (unsigned char) slot - The slot of the oldest sample, about to be overwritten.
+
+Returns :
+    void
+
+Changes :
+    Samples - The front of the queue may be removed.
+**/
+static void queueDrop(slotQueue* q, unsigned char slot) {
+    if (q->len > 0 && q->slot[q->head] == slot) {
+        q->head = (q->head + 1) & SAMPLES_MASK;
+        q->len--;
+    }
+}
+
+/**
+Function Name : samples_init
+
+Description : Empties the buffer and restarts the sequence numbers at 0.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Samples - The buffer, the aggregates and the sequence number are reset.
+**/
+void samples_init(void) {
+    next = 0;
+    count = 0;
+    added = 0;
+    lastTime = 0;
+    sum = 0;
+    minQueue.head = 0;
+    minQueue.len = 0;
+    maxQueue.head = 0;
+    maxQueue.len = 0;
+}
+
+/**
+Function Name : samples_add
+
+Description : Appends a sample, overwriting the oldest once the buffer is full, and updates the
+    aggregates (see the description at the top of the file).
+
+Arguments :
+    (int) temperature - The sample.
+
+Returns :
+    void
+
+Changes :
+    Samples - The sample is added and the aggregates updated.
+**/
+void samples_add(int temperature) {
+    if (count == SAMPLES_SIZE) {
+        sum -= ring[next];
+        queueDrop(&minQueue, next);
+        queueDrop(&maxQueue, next);
+    } else {
+        count++;
+    }
+    ring[next] = temperature;
+    sum += temperature;
+    queuePush(&minQueue, next, 0);
+    queuePush(&maxQueue, next, 1);
+
+    next = (next + 1) & SAMPLES_MASK;
+    added++;
+    lastTime = rtc_get_date();
+}
+
+/**
+Function Name : samples_count
+
+Description : Returns the number of samples in the buffer.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - The number of samples, at most SAMPLES_SIZE.
+
+Changes :
+    N/A
+**/
+unsigned char samples_count(void) {
+    return count;
+}
+
+/**
+Function Name : samples_first_seq
+
+Description : Returns the sequence number of the oldest sample in the buffer. Samples are numbered
+    from 0 at samples_init.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - The sequence number; that of the next sample when the buffer is empty.
+
+Changes :
+    N/A
+**/
+unsigned long samples_first_seq(void) {
+    return added - count;
+}
+
+/**
+Function Name : samples_get
+
+Description : Returns a sample from the buffer.
+
+Arguments :
+    (unsigned char) index - The index of the sample, 0 being the oldest; less than samples_count().
+
+Returns :
+    (int) - The sample.
+
+Changes :
+    N/A
+**/
+int samples_get(unsigned char index) {
+    return ring[(next - count + index) & SAMPLES_MASK];
+}
+
+/**
+Function Name : samples_last_time
+
+Description : Returns the time the newest sample was added.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - The rtc_get_date() time, or 0 when no sample has been added.
+
+Changes :
+    N/A
+**/
+unsigned long samples_last_time(void) {
+    return lastTime;
+}
+
+/**
+Function Name : samples_min
+
+Description : Returns the lowest sample in the buffer, the front of the minimum queue.
+
+Arguments :
+    void
+
+Returns :
+    (int) - The lowest sample, or 0 when the buffer is empty.
+
+Changes :
+    N/A
+**/
+int samples_min(void) {
+    return count == 0 ? 0 : ring[minQueue.slot[minQueue.head]];
+}
+
+/**
+Function Name : samples_max
+
+Description : Returns the highest sample in the buffer, the front of the maximum queue.
+
+Arguments :
+    void
+
+Returns :
+    (int) - The highest sample, or 0 when the buffer is empty.
+
+Changes :
+    N/A
+**/
+int samples_max(void) {
+    return count == 0 ? 0 : ring[maxQueue.slot[maxQueue.head]];
+}
+
+/**
+Function Name : samples_mean
+
+Description : Returns the mean of the samples in the buffer from the running sum, rounded half away
+    from zero. The one division is done here, when a response asks for it, not per sample.
+
+Arguments :
+    void
+
+Returns :
+    (int) - The mean, or 0 when the buffer is empty.
+
+Changes :
+    N/A
+**/
+int samples_mean(void) {
+    if (count == 0) {
+        return 0;
+    }
+    if (sum < 0) {
+        return (int)((sum - count / 2) / count);
+    }
+    return (int)((sum + count / 2) / count);
+}
@@ -0,0 +1,42 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for samples.c; a RAM ring buffer of the most recent temperature samples
+    with the minimum, maximum and mean over them, served by GET /device/samples.
+**/
+#ifndef SAMPLES_H_INCLUDED
+#define SAMPLES_H_INCLUDED
+
+//DEFINES:
+#define SAMPLES_PERIOD_MS   250     //Time between samples
+#define SAMPLES_SIZE        32      //Samples kept, 8 seconds at SAMPLES_PERIOD_MS. A power of two of
+                                    //  at most 128; costs 4 bytes of RAM per sample
+
+//DECLARATIONS:
+void samples_init(void);    //Empty the buffer
+
+void samples_add(int temperature);  //Append a sample, dropping the oldest once the buffer is full
+
+unsigned char samples_count(void);  //Samples in the buffer
+
+unsigned long samples_first_seq(void);  //Sequence number of the oldest sample; sample i has sequence first + i
+
+int samples_get(unsigned char index);   //Sample at 'index', 0 being the oldest
+
+unsigned long samples_last_time(void);  //rtc_get_date() when the newest sample was added
+
+int samples_min(void);  //Lowest sample in the buffer
+
+int samples_max(void);  //Highest sample in the buffer
+
+int samples_mean(void); //Mean of the samples in the buffer, rounded to the nearest integer
+
+#endif
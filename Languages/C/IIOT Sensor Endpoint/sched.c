@@ -0,0 +1,198 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Cooperative tick scheduler. The library's delay slots each hold one countdown, so
+    tasks sharing a slot reset each other's timers (serving a request used to push the next
+    temperature reading back by two seconds). Here a single slot, SCHED_DELAY_SLOT, is left running
+    as a stopwatch and read as a millisecond clock, and every task keeps its own due time on it.
+
+    A task that runs late is due again one period after its previous due time, not one period after
+    it ran, so a busy pass delays a sample but does not shift the ones after it. A task that falls
+    a whole period behind skips the missed runs rather than running them back to back.
+
+    The executive reports after every pass whether it did any work (a task ran, a connection made
+    progress); the time from the first idle pass of a run of idle passes to the next busy pass is
+    counted as idle time, the time the MCU could have spent asleep.
+**/
+
+//INCLUDES:
+#include "delay.h"
+#include "sched.h"
+
+//DEFINES:
+#define SCHED_CLOCK_SPAN    60000   //Stopwatch length in ms; restarted once half of it has run
+
+//DECLARATIONS:
+typedef struct {
+    schedTask run;
+    unsigned int period;
+    unsigned long due;
+} schedEntry;
+
+static schedEntry tasks[SCHED_TASKS];
+static unsigned char taskCount;
+static unsigned long clockBase;     //Clock reading when the stopwatch was last started
+static unsigned long idleMs;
+static unsigned long idleStart;
+static unsigned char idling;        //The last pass did no work
+
+/**
+Function Name : sched_init
+
+Description : Starts the scheduler clock at 0 with no tasks and no idle time.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Delay - SCHED_DELAY_SLOT is started as the scheduler stopwatch.
+**/
+void sched_init(void) {
+    taskCount = 0;
+    clockBase = 0;
+    idleMs = 0;
+    idling = 0;
+    delay_set(SCHED_DELAY_SLOT, SCHED_CLOCK_SPAN);
+}
+
+/**
+Function Name : sched_now
+
+Description : Reads the scheduler clock. The library's delay_get returns the count of a slot, the
+    milliseconds since delay_set, which stops at the limit delay_isdone checks; the stopwatch is
+    restarted, and its reading moved into clockBase, once half of SCHED_CLOCK_SPAN has run, long
+    before its count could stop.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - Milliseconds since sched_init.
+
+Changes :
+    Delay - SCHED_DELAY_SLOT is restarted once half of its span has run.
+**/
+unsigned long sched_now(void) {
+    unsigned int elapsed = delay_get(SCHED_DELAY_SLOT);
+
+    if (elapsed >= SCHED_CLOCK_SPAN / 2) {
+        clockBase += elapsed;
+        delay_set(SCHED_DELAY_SLOT, SCHED_CLOCK_SPAN);
+        elapsed = 0;
+    }
+    return clockBase + elapsed;
+}
+
+/**
+Function Name : sched_add
+
+Description : Adds a periodic task. Tasks run in the order they were added when several are due.
+
+Arguments :
+    (schedTask) run - The function to run.
+    (unsigned int) period - Milliseconds between runs.
+    (unsigned int) delay - Milliseconds until the first run.
+
+Returns :
+    void
+
+Changes :
+    Scheduler - The task is added; calls beyond SCHED_TASKS tasks are ignored.
+**/
+void sched_add(schedTask run, unsigned int period, unsigned int delay) {
+    if (taskCount == SCHED_TASKS) {
+        return;
+    }
+    tasks[taskCount].run = run;
+    tasks[taskCount].period = period;
+    tasks[taskCount].due = sched_now() + delay;
+    taskCount++;
+}
+
+/**
+Function Name : sched_run
+
+Description : Runs every task whose due time has come, once each, and sets its next due time.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - 1 if any task ran, otherwise 0.
+
+Changes :
+    Scheduler - The due times of the tasks that ran are advanced.
+**/
+unsigned char sched_run(void) {
+    unsigned long now = sched_now();
+    unsigned char ran = 0;
+    unsigned char i;
+
+    for (i = 0; i < taskCount; i++) {
+        if ((long)(now - tasks[i].due) >= 0) {
+            tasks[i].run();
+            tasks[i].due += tasks[i].period;
+            if ((long)(now - tasks[i].due) >= 0) {
+                tasks[i].due = now + tasks[i].period;
+            }
+            ran = 1;
+        }
+    }
+    return ran;
+}
+
+/**
+Function Name : sched_account
+
+Description : Called at the end of every pass of the executive to count idle time.
+
+Arguments :
+    (unsigned char) busy - 1 if the pass did any work, 0 if it only found nothing to do.
+
+Returns :
+    void
+
+Changes :
+    Scheduler - A run of idle passes is added to the idle time when it ends.
+**/
+void sched_account(unsigned char busy) {
+    if (!busy && !idling) {
+        idleStart = sched_now();
+        idling = 1;
+    } else if (busy && idling) {
+        idleMs += sched_now() - idleStart;
+        idling = 0;
+    }
+}
+
+/**
+Function Name : sched_idle_ms
+
+Description : Returns the idle time counted so far, including a run of idle passes still under way.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned long) - Milliseconds spent in passes that did no work.
+
+Changes :
+    N/A
+**/
+unsigned long sched_idle_ms(void) {
+    if (idling) {
+        return idleMs + (sched_now() - idleStart);
+    }
+    return idleMs;
+}
@@ -0,0 +1,38 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for sched.c; a cooperative tick scheduler for the cyclic executive. Each
+    task has its own period and due time on a shared millisecond clock, so the periodic work in main.c
+    runs when it is due instead of being polled on every pass, and no task can push another back.
+**/
+#ifndef SCHED_H_INCLUDED
+#define SCHED_H_INCLUDED
+
+//DEFINES:
+#define SCHED_TASKS         5       //Task slots
+#define SCHED_DELAY_SLOT    1       //Delay slot the scheduler clock runs on; no other code may use it
+
+//DECLARATIONS:
+typedef void (*schedTask)(void);
+
+void sched_init(void);  //Start the clock with no tasks
+
+void sched_add(schedTask run, unsigned int period, unsigned int delay);  //Run 'run' every 'period' ms, first after 'delay' ms
+
+unsigned char sched_run(void);  //Run the tasks that are due; 1 if any ran
+
+void sched_account(unsigned char busy);     //Record whether this pass of the executive did any work
+
+unsigned long sched_now(void);  //Milliseconds since sched_init
+
+unsigned long sched_idle_ms(void);  //Milliseconds spent in passes that did no work
+
+#endif
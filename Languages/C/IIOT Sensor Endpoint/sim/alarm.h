@@ -0,0 +1,10 @@
+/**
+Description : Simulated alarm sender for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef ALARM_H_INCLUDED
+#define ALARM_H_INCLUDED
+
+void alarm_send(unsigned char event);
+
+#endif
@@ -0,0 +1,673 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Benchmark driver for the host build of the endpoint. Loads a trace of recorded HTTP
+    requests, replays it through the unmodified cyclic executive in main.c (linked as
+    endpoint_main) and reports, per distinct request line and overall, the latency percentiles,
+    bytes written per response and W5x SPI transactions per response.
+
+    Usage : bench [-n iterations] [-c clients] [-r rtt_us] [-t bytes_per_ms] [-w bytes_per_ms]
+                  [-N ntp_ms] [-f] [-k] [-p depth] [-d dumpfile] [-T temperature_profile] [tracefile]
+
+    Latency is reported twice: 'sim' latency is measured on the simulated clock, which charges every
+    W5x SPI transaction and EEPROM byte write with the cost model in sim.h, from the moment a client
+    sends its request until the last byte of the response (as framed by its Content-Length, or the
+    disconnect for a response without one) has been written; 'host' latency is the wall-clock time
+    the host spent over the same span. Clients run closed-loop, each sending its next request as
+    soon as its previous response has completed; -t makes their request bytes trickle in at the
+    given rate instead of arriving all at once, and -w sets the rate they read responses at, which
+    drains the W5x transmit buffer (1000 bytes/ms by default, 0 for at once). A write that finds the
+    transmit buffer full stalls the executive until the client has made room, and is counted in the
+    report. The duration of every pass through the cyclic executive is also recorded, to check the
+    worst-case loop latency while serving, and so are the interval between temperature conversions,
+    to check that sampling keeps its cadence under load, and the scheduler's idle time (see
+    ../sched.c). A trace that restarts the endpoint (traces/restart.txt) also gets the longest time
+    from a restart until a server socket listened again. The report ends with the longest time
+    between two watchdog resets and how many of them exceeded the watchdog timeout, which the
+    simulation counts rather than acting on. -N sets how long one NTP try takes (400 ms by default)
+    and -f makes every try go unanswered, as when the NTP server is unreachable; with
+    traces/restart.txt and a temperature profile to keep the executive running, this shows what the
+    background NTP attempts after a fast boot (see ../boot.c) cost the loop.
+
+    By default every request carries "Connection: close" and uses a connection of its own. With -k
+    each client keeps its connection open and sends its following requests on it, half a round trip
+    apart instead of a full connect; -p sends 'depth' requests back to back on the connection before
+    waiting for their responses (pipelining, implies -k). A client that holds a connection keeps it
+    until the trace is done, so with -k only as many clients as there are server sockets get served.
+
+    -T replaces the constant temperature with a profile of timed readings (see traces/temp_*.txt),
+    and the executive keeps running after the last response until the profile has played out. The
+    report then shows how many log records and alarms the readings caused, and how many alarms the
+    alarm queue merged instead of sending; running the same profile with a trace that sets the
+    filter (traces/filter.txt) and one that does not (traces/poll.txt) compares the alarm traffic
+    with and without it. The report also gives the event of the last alarm sent and the temperature
+    state at the end, which should agree (traces/temp_order.txt).
+**/
+
+//INCLUDES:
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "socket.h"
+#include "sim.h"
+#include "sched.h"
+#include "log.h"
+#include "alarmq.h"
+#include "tempfsm.h"
+
+//DEFINES:
+#define MAX_REQUESTS    256
+#define MAX_LABELS      64
+#define LABEL_LEN       48
+#define MAX_CLIENTS     16
+#define DUMP_SIZE       8192
+#define HEAD_SIZE       512         /* response status line and headers kept for parsing */
+#define MAX_DEPTH       8           /* requests in flight on one connection */
+#define CLOSE_HEADER    "Connection: close\r\n"
+#define LOOP_BUCKET_US  10          /* resolution of the loop pass histogram */
+#define LOOP_BUCKETS    20000
+#define MAX_PROFILE     100000      /* readings in a temperature profile */
+
+//DECLARATIONS:
+typedef struct {
+    char *text;
+    unsigned int len;
+    char *close_text;   /* the same request with a "Connection: close" header */
+    unsigned int close_len;
+    int label;
+} trace_request;
+
+typedef struct {
+    int label;
+    unsigned long sim_us;
+    unsigned long host_ns;
+    unsigned long reads;
+    unsigned long writes;
+    unsigned long bytes;
+} sample;
+
+typedef struct {
+    int client;
+    long pending[MAX_DEPTH];    /* requests sent and not yet answered, oldest first */
+    int npending;
+    unsigned long long sim_start;   /* when the requests in flight were sent */
+    struct timespec host_start;
+    sim_counters base;          /* connection counters when the previous response completed */
+    char head[HEAD_SIZE];       /* response headers received so far */
+    unsigned int headlen;
+    unsigned char in_body;
+    unsigned char framed;       /* the response has a Content-Length */
+    unsigned char closing;      /* the server announced it closes the connection */
+    unsigned long body_left;
+    char dump[DUMP_SIZE];
+    unsigned int dumplen;
+} connection;
+
+int endpoint_main(void);
+
+static trace_request trace[MAX_REQUESTS];
+static int trace_len;
+static char labels[MAX_LABELS][LABEL_LEN];
+static int label_count;
+
+static sample *samples;
+static long total_requests;
+static long issued;
+static long completed;
+static long resent;
+static long retry[SIM_SOCKETS * MAX_DEPTH];     /* requests to resend after their connection closed */
+static int nretry;
+
+static int clients = 1;
+static int keep_alive;
+static int depth = 1;
+static unsigned char started;
+static unsigned long restarts;
+static unsigned char restart_pending;   /* restarted, and no server socket has listened since */
+static unsigned long long restart_us;
+static unsigned long long restart_max_us;   /* longest time from a restart until a socket listened */
+static unsigned long long first_request_us;
+static unsigned long long last_response_us;
+static unsigned long long client_ready[MAX_CLIENTS];
+static unsigned char client_busy[MAX_CLIENTS];
+static connection conns[SIM_SOCKETS];
+static unsigned char conn_active[SIM_SOCKETS];
+static FILE *dump;
+static unsigned long loop_hist[LOOP_BUCKETS];
+static unsigned long loop_passes;
+static unsigned long loop_max;
+static unsigned long loop_max_cpu;
+static unsigned long long profile_us[MAX_PROFILE];
+static int profile_value[MAX_PROFILE];
+static long profile_len;
+static long profile_next;       /* next reading to take effect */
+
+/**
+Function Name : load_trace
+
+Description : Reads a trace file. Requests are separated by blank lines; each line is sent with
+    a CRLF terminator and every request ends with the blank line that closes its headers. Lines
+    starting with '#' between requests are comments.
+**/
+static int load_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[512];
+    char buf[SIM_RX_SIZE];
+    unsigned int len = 0;
+
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    for (;;) {
+        char *got = fgets(line, sizeof(line), f);
+        size_t n;
+
+        if (got != NULL) {
+            n = strcspn(line, "\r\n");
+            line[n] = '\0';
+            if (len == 0 && (n == 0 || line[0] == '#')) {
+                continue;
+            }
+        }
+        if (got == NULL || line[0] == '\0') {
+            if (len > 0 && trace_len < MAX_REQUESTS) {
+                int i;
+                char label[LABEL_LEN];
+                size_t l;
+
+                memcpy(buf + len, "\r\n", 2);
+                len += 2;
+                trace[trace_len].text = malloc(len);
+                memcpy(trace[trace_len].text, buf, len);
+                trace[trace_len].len = len;
+
+                /* the close variant has the header right after the request line */
+                l = strcspn(buf, "\n") + 1;
+                trace[trace_len].close_len = len + (unsigned int)sizeof(CLOSE_HEADER) - 1;
+                trace[trace_len].close_text = malloc(trace[trace_len].close_len);
+                memcpy(trace[trace_len].close_text, buf, l);
+                memcpy(trace[trace_len].close_text + l, CLOSE_HEADER, sizeof(CLOSE_HEADER) - 1);
+                memcpy(trace[trace_len].close_text + l + sizeof(CLOSE_HEADER) - 1, buf + l, len - l);
+
+                l = strcspn(buf, "\r");
+                if (l >= LABEL_LEN) {
+                    l = LABEL_LEN - 1;
+                }
+                memcpy(label, buf, l);
+                label[l] = '\0';
+                for (i = 0; i < label_count && strcmp(labels[i], label) != 0; i++) {}
+                if (i == label_count && label_count < MAX_LABELS) {
+                    strcpy(labels[label_count++], label);
+                }
+                trace[trace_len].label = i;
+                trace_len++;
+            }
+            len = 0;
+            if (got == NULL) {
+                break;
+            }
+            continue;
+        }
+        if (len + n + 4 < sizeof(buf)) {
+            memcpy(buf + len, line, n);
+            len += (unsigned int)n;
+            memcpy(buf + len, "\r\n", 2);
+            len += 2;
+            buf[len] = '\0';
+        }
+    }
+    fclose(f);
+    return trace_len;
+}
+
+/**
+Function Name : load_profile
+
+Description : Reads a temperature profile: one "<ms> <degrees>" reading per line in increasing time
+    order, each held until the next. Lines starting with '#' are comments.
+**/
+static int load_profile(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+    unsigned long ms;
+    int value;
+
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    while (fgets(line, sizeof(line), f) != NULL && profile_len < MAX_PROFILE) {
+        if (line[0] == '#' || sscanf(line, "%lu %d", &ms, &value) != 2) {
+            continue;
+        }
+        profile_us[profile_len] = ms * 1000ULL;
+        profile_value[profile_len] = value;
+        profile_len++;
+    }
+    fclose(f);
+    return profile_len > 0;
+}
+
+static unsigned long elapsed_ns(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)((now.tv_sec - start->tv_sec) * 1000000000L + (now.tv_nsec - start->tv_nsec));
+}
+
+/**
+Function Name : send_requests
+
+Description : Sends the client on a connection its next requests: one, or 'depth' back to back when
+    pipelining. A new connection is opened with them; an open one carries them after the previous
+    responses.
+**/
+static void send_requests(SOCKET s, int connect) {
+    connection *conn = &conns[s];
+    char buf[SIM_RX_SIZE];
+    unsigned int len = 0;
+
+    conn->npending = 0;
+    while (conn->npending < depth && (nretry > 0 || issued < total_requests)) {
+        long request = nretry > 0 ? retry[0] : issued;
+        trace_request *req = &trace[request % trace_len];
+        char *text = keep_alive ? req->text : req->close_text;
+        unsigned int n = keep_alive ? req->len : req->close_len;
+
+        if (len + n > sizeof(buf)) {
+            break;
+        }
+        memcpy(buf + len, text, n);
+        len += n;
+        conn->pending[conn->npending++] = request;
+        if (nretry > 0) {
+            memmove(retry, retry + 1, sizeof(retry[0]) * (size_t)--nretry);
+        } else {
+            issued++;
+        }
+    }
+    if (connect) {
+        sim_socket_inject(s, buf, len);
+        memset(&conn->base, 0, sizeof(conn->base));
+    } else {
+        conn->sim_start = sim_clock_us;
+        sim_socket_send(s, buf, len);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &conn->host_start);
+}
+
+/**
+Function Name : sim_on_idle
+
+Description : A socket is listening and has nothing in its receive buffer. Connects the client
+    that has been waiting longest, if any, and sends it the next requests of the trace.
+**/
+void sim_on_idle(SOCKET s) {
+    int c;
+    int pick = -1;
+
+    if (restart_pending) {
+        if (sim_clock_us - restart_us > restart_max_us) {
+            restart_max_us = sim_clock_us - restart_us;
+        }
+        restart_pending = 0;
+    }
+    if (conn_active[s] || (nretry == 0 && issued == total_requests)) {
+        return;
+    }
+    /* clients start sending once the server first listens, so boot time is not charged to them */
+    if (!started) {
+        for (c = 0; c < clients; c++) {
+            client_ready[c] = sim_clock_us;
+        }
+        first_request_us = sim_clock_us;
+        started = 1;
+    }
+    for (c = 0; c < clients; c++) {
+        if (!client_busy[c] && client_ready[c] <= sim_clock_us &&
+            (pick < 0 || client_ready[c] < client_ready[pick])) {
+            pick = c;
+        }
+    }
+    if (pick < 0) {
+        return;
+    }
+
+    conns[s].client = pick;
+    conns[s].sim_start = client_ready[pick];
+    conns[s].headlen = 0;
+    conns[s].in_body = 0;
+    conns[s].closing = 0;
+    conns[s].dumplen = 0;
+    client_busy[pick] = 1;
+    conn_active[s] = 1;
+    send_requests(s, 1);
+}
+
+/**
+Function Name : response_done
+
+Description : The oldest request in flight on a connection has been answered in full. Records its
+    sample and, once every request in flight is answered, lets a keep-alive client send its next
+    requests, or close the connection when the trace is done. Nothing more is sent on a connection
+    the server said it will close.
+**/
+static void response_done(SOCKET s) {
+    connection *conn = &conns[s];
+    sim_counters *counters = sim_socket_counters(s);
+    sample *out = &samples[completed++];
+    long request = conn->pending[0];
+
+    out->label = trace[request % trace_len].label;
+    out->sim_us = (unsigned long)(sim_clock_us - conn->sim_start);
+    out->host_ns = elapsed_ns(&conn->host_start);
+    out->reads = counters->spi_reads - conn->base.spi_reads;
+    out->writes = counters->spi_writes - conn->base.spi_writes;
+    out->bytes = counters->bytes_written - conn->base.bytes_written;
+    conn->base = *counters;
+    last_response_us = sim_clock_us;
+
+    if (dump != NULL && request < trace_len) {
+        fprintf(dump, "### %s\n", labels[out->label]);
+        fwrite(conn->dump, 1, conn->dumplen, dump);
+        fputc('\n', dump);
+    }
+    conn->dumplen = 0;
+    conn->headlen = 0;
+    conn->in_body = 0;
+
+    conn->npending--;
+    memmove(conn->pending, conn->pending + 1, sizeof(conn->pending[0]) * (size_t)conn->npending);
+    if (conn->npending == 0 && keep_alive && !conn->closing) {
+        if (nretry > 0 || issued < total_requests) {
+            send_requests(s, 0);
+        } else {
+            sim_socket_client_close(s);
+        }
+    }
+}
+
+/**
+Function Name : sim_on_write
+
+Description : Response bytes written by the server. The client parses the status line and headers
+    for a Content-Length and counts off the body, so it can tell where each response ends on a
+    connection that stays open.
+**/
+void sim_on_write(SOCKET s, const char *buf, unsigned int len) {
+    connection *conn = &conns[s];
+
+    if (!conn_active[s] || conn->npending == 0) {
+        return;
+    }
+    while (len > 0) {
+        unsigned int n = 1;
+
+        if (!conn->in_body) {
+            char *length;
+
+            if (conn->headlen < HEAD_SIZE - 1) {
+                conn->head[conn->headlen++] = *buf;
+            }
+            if (conn->headlen >= 4 && memcmp(conn->head + conn->headlen - 4, "\r\n\r\n", 4) == 0) {
+                conn->head[conn->headlen] = '\0';
+                length = strstr(conn->head, "Content-Length:");
+                conn->framed = length != NULL;
+                conn->body_left = length != NULL ? strtoul(length + 15, NULL, 10) : 0;
+                conn->closing |= strstr(conn->head, "Connection: close") != NULL;
+                conn->in_body = 1;
+            }
+        } else if (conn->framed) {
+            n = len < conn->body_left ? len : (unsigned int)conn->body_left;
+            conn->body_left -= n;
+        } else {
+            n = len;
+        }
+        if (dump != NULL && conn->dumplen + n <= DUMP_SIZE) {
+            memcpy(conn->dump + conn->dumplen, buf, n);
+            conn->dumplen += n;
+        }
+        buf += n;
+        len -= n;
+        if (conn->in_body && conn->framed && conn->body_left == 0) {
+            response_done(s);
+            if (conn->npending == 0) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+Function Name : sim_on_disconnect
+
+Description : The server closed a connection. A response without a Content-Length ends here;
+    requests still unanswered are queued to be sent again. Frees the client to connect again.
+**/
+void sim_on_disconnect(SOCKET s) {
+    connection *conn = &conns[s];
+
+    if (!conn_active[s]) {
+        return;
+    }
+    if (conn->npending > 0 && conn->in_body && !conn->framed) {
+        response_done(s);
+    }
+    /* a pipelined request that was never answered is sent again on a new connection */
+    memcpy(retry + nretry, conn->pending, sizeof(conn->pending[0]) * (size_t)conn->npending);
+    nretry += conn->npending;
+    resent += conn->npending;
+    conn->npending = 0;
+
+    client_busy[conn->client] = 0;
+    client_ready[conn->client] = sim_clock_us;
+    last_response_us = sim_clock_us;
+    conn_active[s] = 0;
+}
+
+void sim_on_loop(unsigned long pass_us, unsigned long eeprom_us) {
+    unsigned long bucket = pass_us / LOOP_BUCKET_US;
+    while (profile_next < profile_len && profile_us[profile_next] <= sim_clock_us) {
+        sim_temperature = profile_value[profile_next++];
+    }
+    if (!started) {
+        return;
+    }
+    if (pass_us - eeprom_us > loop_max_cpu) {
+        loop_max_cpu = pass_us - eeprom_us;
+    }
+    loop_hist[bucket < LOOP_BUCKETS ? bucket : LOOP_BUCKETS - 1]++;
+    loop_passes++;
+    if (pass_us > loop_max) {
+        loop_max = pass_us;
+    }
+}
+
+static unsigned long loop_percentile(int permille) {
+    unsigned long target = (loop_passes * (unsigned long)permille + 999) / 1000;
+    unsigned long seen = 0;
+    unsigned long i;
+    for (i = 0; i < LOOP_BUCKETS; i++) {
+        seen += loop_hist[i];
+        if (seen >= target) {
+            return (i + 1) * LOOP_BUCKET_US;
+        }
+    }
+    return loop_max;
+}
+
+unsigned char sim_should_stop(void) {
+    return completed == total_requests && profile_next == profile_len;
+}
+
+static int cmp_ulong(const void *a, const void *b) {
+    unsigned long x = *(const unsigned long *)a;
+    unsigned long y = *(const unsigned long *)b;
+    return (x > y) - (x < y);
+}
+
+static unsigned long percentile(unsigned long *sorted, long n, int pct) {
+    long idx = (n * pct + 99) / 100 - 1;
+    if (idx < 0) {
+        idx = 0;
+    }
+    return sorted[idx];
+}
+
+/**
+Function Name : report
+
+Description : Prints one row of the result table for all samples with the given label, or for
+    every sample when label is -1.
+**/
+static void report(const char *name, int label) {
+    unsigned long *sim = malloc(sizeof(unsigned long) * (size_t)completed);
+    unsigned long *host = malloc(sizeof(unsigned long) * (size_t)completed);
+    unsigned long long bytes = 0, writes = 0, reads = 0;
+    long n = 0;
+    long i;
+
+    for (i = 0; i < completed; i++) {
+        if (label >= 0 && samples[i].label != label) {
+            continue;
+        }
+        sim[n] = samples[i].sim_us;
+        host[n] = samples[i].host_ns;
+        bytes += samples[i].bytes;
+        writes += samples[i].writes;
+        reads += samples[i].reads;
+        n++;
+    }
+    if (n > 0) {
+        qsort(sim, (size_t)n, sizeof(unsigned long), cmp_ulong);
+        qsort(host, (size_t)n, sizeof(unsigned long), cmp_ulong);
+        printf("%-40.40s %6ld %8lu %8lu %8lu %8lu %8lu %8lu %9.1f %8.1f %8.1f\n",
+               name, n,
+               percentile(sim, n, 50), percentile(sim, n, 90), percentile(sim, n, 99), sim[n - 1],
+               percentile(host, n, 50), percentile(host, n, 99),
+               (double)bytes / n, (double)writes / n, (double)reads / n);
+    }
+    free(sim);
+    free(host);
+}
+
+int main(int argc, char **argv) {
+    const char *path = "traces/traffic.txt";
+    long iterations = 100;
+    int i;
+    int rc;
+    struct timespec wall;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            clients = atoi(argv[++i]);
+            if (clients < 1 || clients > MAX_CLIENTS) {
+                fprintf(stderr, "clients must be 1..%d\n", MAX_CLIENTS);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            sim_rtt_us = (unsigned long)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            sim_trickle = (unsigned long)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            sim_drain = (unsigned long)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-N") == 0 && i + 1 < argc) {
+            sim_ntp_us = (unsigned long)atol(argv[++i]) * 1000UL;
+        } else if (strcmp(argv[i], "-f") == 0) {
+            sim_ntp_fail = 1;
+        } else if (strcmp(argv[i], "-k") == 0) {
+            keep_alive = 1;
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            depth = atoi(argv[++i]);
+            keep_alive = 1;
+            if (depth < 1 || depth > MAX_DEPTH) {
+                fprintf(stderr, "depth must be 1..%d\n", MAX_DEPTH);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            dump = fopen(argv[++i], "w");
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            if (!load_profile(argv[++i])) {
+                fprintf(stderr, "%s: no readings\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [-n iterations] [-c clients] [-r rtt_us] [-t bytes_per_ms] [-w bytes_per_ms] [-N ntp_ms] [-f] [-k] [-p depth] [-d dumpfile] [-T temperature_profile] [tracefile]\n", argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!load_trace(path)) {
+        fprintf(stderr, "%s: no requests\n", path);
+        return 1;
+    }
+
+    total_requests = (long)trace_len * iterations;
+    samples = calloc((size_t)total_requests, sizeof(sample));
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+
+    /* a forced watchdog restart re-enters the executive from the top, like a reset would */
+    rc = setjmp(sim_exit);
+    if (rc == 2) {
+        restarts++;
+        restart_pending = 1;
+        restart_us = sim_clock_us;
+    }
+    if (rc == 0 || rc == 2) {
+        endpoint_main();
+    }
+
+    printf("trace %s: %d requests x %ld iterations, %d client(s), %s, %lu us rtt, %.3f s simulated, %.3f s host\n",
+           path, trace_len, iterations, clients,
+           !keep_alive ? "connection per request" : depth > 1 ? "keep-alive, pipelined" : "keep-alive",
+           sim_rtt_us, sim_clock_us / 1e6, elapsed_ns(&wall) / 1e9);
+    printf("%-40s %6s %8s %8s %8s %8s %8s %8s %9s %8s %8s\n", "request", "count",
+           "sim p50", "sim p90", "sim p99", "sim max", "host p50", "host p99",
+           "bytes", "writes", "reads");
+    printf("%-40s %6s %8s %8s %8s %8s %8s %8s %9s %8s %8s\n", "", "",
+           "us", "us", "us", "us", "ns", "ns", "/resp", "/resp", "/resp");
+    for (i = 0; i < label_count; i++) {
+        report(labels[i], i);
+    }
+    report("all requests", -1);
+    printf("loop pass: %lu passes, p50 <%lu us, p99 <%lu us, p99.9 <%lu us, max %lu us (%lu us excluding EEPROM writes)\n",
+           loop_passes, loop_percentile(500), loop_percentile(990), loop_percentile(999), loop_max, loop_max_cpu);
+    printf("throughput: %.1f requests/s simulated\n",
+           completed * 1e6 / (double)(last_response_us - first_request_us));
+    printf("eeprom bytes written: %lu, alarms sent: %lu (posted %lu, merged %lu), requests resent: %ld\n",
+           sim_eeprom_writes, sim_alarms, alarmq_posted(), alarmq_merged(), resent);
+    printf("transmit buffer: drained at %lu bytes/ms, %lu writes stalled waiting for room\n", sim_drain, sim_tx_stalls);
+    printf("temperature samples: %lu, interval min %.1f ms, max %.1f ms; idle %lu of %lu ms\n",
+           sim_temp_reads, sim_temp_gap_min_us / 1e3, sim_temp_gap_max_us / 1e3, sched_idle_ms(), sched_now());
+    if (restarts > 0) {
+        printf("restarts: %lu, restart to listening: max %.1f ms\n", restarts, restart_max_us / 1e3);
+    }
+    printf("watchdog: longest %.1f ms between resets, %lu timeouts; ntp: %lu tries of %.1f ms, %s\n",
+           sim_wdt_max_us / 1e3, sim_wdt_timeouts, sim_ntp_tries, sim_ntp_us / 1e3,
+           sim_ntp_fail ? "none answered" : "answered");
+    if (profile_len > 0) {
+        printf("temperature profile: %ld readings over %.1f s; log records since power-on: %lu, kept: %u\n",
+               profile_len, profile_us[profile_len - 1] / 1e6, log_get_first_seq() + log_get_num_entries(),
+               log_get_num_entries());
+        printf("last alarm sent: event %u; temperature state at the end: %s\n",
+               sim_last_alarm, tempfsm_state_name(tempfsm_get_state()));
+    }
+
+    if (dump != NULL) {
+        fclose(dump);
+    }
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,25 @@
+/**
+Description : Simulated EEPROM configuration block for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef CONFIG_H_INCLUDED
+#define CONFIG_H_INCLUDED
+
+typedef struct {
+    char token[4];
+    int hi_alarm;
+    int hi_warn;
+    int lo_alarm;
+    int lo_warn;
+    char use_static_ip;
+    unsigned char static_ip[4];
+    unsigned char checksum;
+} config_struct;
+
+extern config_struct config;
+
+void config_init(void);
+void config_update(void);
+void config_set_modified(void);
+
+#endif
@@ -0,0 +1,12 @@
+/**
+Description : Simulated millisecond delay slots for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef DELAY_H_INCLUDED
+#define DELAY_H_INCLUDED
+
+void delay_set(unsigned int num, unsigned int time);
+unsigned char delay_isdone(unsigned int num);
+unsigned int delay_get(unsigned int num);
+
+#endif
@@ -0,0 +1,13 @@
+/**
+Description : Simulated DHCP client for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef DHCP_H_INCLUDED
+#define DHCP_H_INCLUDED
+
+unsigned char dhcp_start(unsigned char *mac, unsigned long timeout, unsigned long responseTimeout);
+unsigned char *dhcp_getLocalIp(void);
+unsigned char *dhcp_getGatewayIp(void);
+unsigned char *dhcp_getSubnetMask(void);
+
+#endif
@@ -0,0 +1,12 @@
+/**
+Description : Simulated EEPROM driver for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef EEPROM_H_INCLUDED
+#define EEPROM_H_INCLUDED
+
+void eeprom_writebuf(unsigned int addr, unsigned char *buf, unsigned char size);
+void eeprom_readbuf(unsigned int addr, unsigned char *buf, unsigned char size);
+unsigned char eeprom_isbusy(void);
+
+#endif
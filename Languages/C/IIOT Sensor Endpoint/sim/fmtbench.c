@@ -0,0 +1,297 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Equivalence check and microbenchmark for the integer-only formatters in ../fmt.c.
+    Compares fmt_dec, fmt_date and fmt_mac character for character against the text the library
+    writes (printf "%ld", the simulated rtc_num2datestr in sim_hw.c, which follows the board RTC
+    library, and "%02X:" pairs) and then times both on the host.
+
+    Usage : fmtbench [-q]
+
+    The decimal check covers every value within +-2^20, both sides of every power of ten and the
+    ends of the 32-bit range (a long on the AVR), plus random values. The date check formats every day the RTC can reach
+    at its first and last second, every second of days around the month, leap year and century
+    edges, long increasing sequences with mixed step sizes (the incremental path taken for log
+    records) and random times in random order (the fallback path). -q skips the timing. Exits with
+    status 1 at the first mismatch.
+
+    Host times do not carry over to the AVR, where the library's 32-bit divisions are calls into a
+    software division routine; the counts in the report are the useful figure there.
+**/
+
+//INCLUDES:
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "socket.h"
+#include "rtc.h"
+#include "fmt.h"
+
+//DEFINES:
+#define LAST_DAY    49710UL     /* last whole day an unsigned long of seconds reaches */
+
+//DECLARATIONS:
+static unsigned long long checked;
+static unsigned long rng = 12345;
+static volatile char sink;
+
+//sim_hw.c hooks that the formatters never reach
+unsigned char sim_should_stop(void) { return 0; }
+void sim_on_loop(unsigned long pass_us, unsigned long eeprom_us) { (void)pass_us; (void)eeprom_us; }
+void socket_disconnect(SOCKET s) { (void)s; }
+
+static unsigned long next_random(void) {
+    rng = rng * 1103515245UL + 12345UL;
+    return ((rng >> 16) ^ (rng << 16)) & 0xFFFFFFFFUL;
+}
+
+static double now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void fail(const char* what, const char* expected, const char* got, unsigned long long input) {
+    fprintf(stderr, "fmtbench: %s mismatch for %llu: expected \"%s\" got \"%s\"\n", what, input, expected, got);
+    exit(1);
+}
+
+/* The digit loop strbuf_putdec used before fmt_dec, for timing. */
+static unsigned char old_dec(char* out, long value) {
+    char digits[10];
+    unsigned char n = 0;
+    unsigned char len = 0;
+    unsigned long magnitude;
+
+    if (value < 0) {
+        out[len++] = '-';
+        magnitude = 0UL - (unsigned long)value;
+    } else {
+        magnitude = (unsigned long)value;
+    }
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    while (n > 0) {
+        out[len++] = digits[--n];
+    }
+    return len;
+}
+
+static void check_dec(long value) {
+    char expected[16];
+    char got[FMT_DEC_MAX + 1];
+
+    snprintf(expected, sizeof(expected), "%ld", value);
+    got[fmt_dec(got, value)] = 0;
+    if (strcmp(expected, got) != 0) {
+        fail("fmt_dec", expected, got, (unsigned long long)value);
+    }
+    checked++;
+}
+
+static void check_date(unsigned long seconds) {
+    char got[FMT_DATE_LEN + 1];
+
+    fmt_date(got, seconds);
+    got[FMT_DATE_LEN] = 0;
+    if (strcmp(rtc_num2datestr(seconds), got) != 0) {
+        fail("fmt_date", rtc_num2datestr(seconds), got, seconds);
+    }
+    checked++;
+}
+
+static void check_mac(unsigned char* mac) {
+    char expected[24];
+    char got[FMT_MAC_LEN + 1];
+
+    snprintf(expected, sizeof(expected), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    fmt_mac(got, mac);
+    got[FMT_MAC_LEN] = 0;
+    if (strcmp(expected, got) != 0) {
+        fail("fmt_mac", expected, got, 0);
+    }
+    checked++;
+}
+
+static void check_all(void) {
+    static const unsigned int edge_years[] = {1970, 1972, 1999, 2000, 2024, 2026, 2038, 2099, 2100, 2101, 2105};
+    unsigned long long t;
+    unsigned long day;
+    unsigned long p;
+    unsigned long s;
+    unsigned long i;
+    unsigned int y;
+    unsigned char mac[6];
+    long v;
+
+    //Decimal
+    for (v = -(1L << 20); v <= (1L << 20); v++) {
+        check_dec(v);
+    }
+    for (p = 1; p <= 1000000000UL; p *= 10) {
+        check_dec((long)p - 1);
+        check_dec((long)p);
+        check_dec((long)p + 1);
+        check_dec(-(long)p + 1);
+        check_dec(-(long)p);
+        check_dec(-(long)p - 1);
+    }
+    check_dec(2147483647L);
+    check_dec(-2147483647L - 1);
+    check_dec(32767);
+    check_dec(-32768);
+    for (i = 0; i < 5000000UL; i++) {
+        check_dec((long)(int)next_random());
+    }
+    printf("fmt_dec  : %llu values match\n", checked);
+
+    //Every reachable day at its first and last second, in increasing and in random order
+    checked = 0;
+    for (day = 0; day <= LAST_DAY; day++) {
+        check_date(day * 86400UL);
+        check_date(day * 86400UL + 86399UL);
+    }
+    for (day = LAST_DAY + 1; day-- > 0;) {
+        check_date(day * 86400UL + next_random() % 86400UL);
+    }
+    check_date(0xFFFFFFFFUL);
+
+    //Every second around month, leap year and century edges
+    for (y = 0; y < sizeof(edge_years) / sizeof(edge_years[0]); y++) {
+        unsigned long start = 0;
+        unsigned int year;
+        for (year = 1970; year < edge_years[y]; year++) {
+            start += ((year % 4) == 0 && year != 2100) ? 366UL * 86400UL : 365UL * 86400UL;
+        }
+        //Feb 27 to Mar 2 of that year, and the last two days of the year before and first two of it
+        for (s = start + 57UL * 86400UL; s < start + 61UL * 86400UL; s++) {
+            check_date(s);
+        }
+        if (start >= 2UL * 86400UL) {
+            for (s = start - 2UL * 86400UL; s < start + 2UL * 86400UL; s++) {
+                check_date(s);
+            }
+        }
+    }
+
+    //Increasing sequences: same day, a few minutes, a few days, more than the step limit
+    for (i = 0; i < 4; i++) {
+        static const unsigned long max_step[] = {600UL, 86400UL, 5UL * 86400UL, 90UL * 86400UL};
+        for (t = next_random() % 86400UL; t <= 0xFFFFFFFFULL; t += 1 + next_random() % max_step[i]) {
+            check_date((unsigned long)t);
+        }
+    }
+
+    //Random order
+    for (i = 0; i < 2000000UL; i++) {
+        check_date(next_random());
+    }
+    printf("fmt_date : %llu values match\n", checked);
+
+    //MAC
+    checked = 0;
+    for (i = 0; i < 256; i++) {
+        memset(mac, (int)i, sizeof(mac));
+        mac[0] = (unsigned char)(255 - i);
+        check_mac(mac);
+    }
+    for (i = 0; i < 200000UL; i++) {
+        for (y = 0; y < 6; y++) {
+            mac[y] = (unsigned char)next_random();
+        }
+        check_mac(mac);
+    }
+    printf("fmt_mac  : %llu values match\n", checked);
+}
+
+static void time_all(void) {
+    enum { ROUNDS = 200000, RECORDS = 16 };
+    static unsigned char mac[6] = {0x00, 0x08, 0xDC, 0x1D, 0x4A, 0x7F};
+    long values[8] = {200, 400, 85, 120, -40, 23, 1461, 1761903600L};
+    unsigned long times[RECORDS];
+    char text[32];
+    double start;
+    double old_ns;
+    double new_ns;
+    unsigned long i;
+    unsigned char r;
+
+    //Decimals of the sizes a /device response carries
+    start = now_ns();
+    for (i = 0; i < ROUNDS; i++) {
+        for (r = 0; r < 8; r++) {
+            sink += text[old_dec(text, values[r]) - 1];
+        }
+    }
+    old_ns = (now_ns() - start) / (ROUNDS * 8.0);
+    start = now_ns();
+    for (i = 0; i < ROUNDS; i++) {
+        for (r = 0; r < 8; r++) {
+            sink += text[fmt_dec(text, values[r]) - 1];
+        }
+    }
+    new_ns = (now_ns() - start) / (ROUNDS * 8.0);
+    printf("decimal  : %6.1f ns library loop  %6.1f ns fmt_dec   (%.2fx)\n", old_ns, new_ns, old_ns / new_ns);
+
+    //A full log of records a few minutes apart, oldest first, as a log response formats them
+    times[0] = 1761903600UL;
+    for (r = 1; r < RECORDS; r++) {
+        times[r] = times[r - 1] + 60 + next_random() % 1800;
+    }
+    start = now_ns();
+    for (i = 0; i < ROUNDS / 4; i++) {
+        for (r = 0; r < RECORDS; r++) {
+            sink += rtc_num2datestr(times[r])[18];
+        }
+    }
+    old_ns = (now_ns() - start) / (ROUNDS / 4 * (double)RECORDS);
+    start = now_ns();
+    for (i = 0; i < ROUNDS / 4; i++) {
+        for (r = 0; r < RECORDS; r++) {
+            fmt_date(text, times[r]);
+            sink += text[18];
+        }
+    }
+    new_ns = (now_ns() - start) / (ROUNDS / 4 * (double)RECORDS);
+    printf("log date : %6.1f ns rtc_num2datestr %6.1f ns fmt_date  (%.2fx)\n", old_ns, new_ns, old_ns / new_ns);
+
+    start = now_ns();
+    for (i = 0; i < ROUNDS; i++) {
+        snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        sink += text[16];
+    }
+    old_ns = (now_ns() - start) / ROUNDS;
+    start = now_ns();
+    for (i = 0; i < ROUNDS; i++) {
+        fmt_mac(text, mac);
+        sink += text[16];
+    }
+    new_ns = (now_ns() - start) / ROUNDS;
+    printf("mac      : %6.1f ns snprintf        %6.1f ns fmt_mac   (%.2fx)\n", old_ns, new_ns, old_ns / new_ns);
+
+    //What the AVR pays for: 32-bit divisions, each a call into the division routine
+    printf("32-bit divisions: library 2 per digit and 6 per date (plus a walk of every year since 1970);\n"
+           "                  fmt_dec 0, fmt_date 0 within %d days of the previous date, else 1\n", 31);
+}
+
+int main(int argc, char** argv) {
+    check_all();
+    if (!(argc > 1 && strcmp(argv[1], "-q") == 0)) {
+        time_all();
+    }
+    return 0;
+}
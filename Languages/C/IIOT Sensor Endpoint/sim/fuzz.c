@@ -0,0 +1,533 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Fuzz harness and parser stress run for the host build of the endpoint. Every input is
+    written into the receive buffer of a simulated socket and the unmodified request FSM in
+    ../parser.c is called on it until it settles, exactly as the cyclic executive would call it, so
+    the route trie, the query parsers, the header scan and every response builder see untrusted
+    bytes. The first byte of an input picks how the bytes arrive: all at once, or trickled in at 1 to
+    64 bytes per ms, so lines split across calls are covered too. It also picks how fast the client
+    reads the responses: at once, or at 8, 64 or 512 bytes per ms, so answers that wait for room in
+    the transmit buffer are covered.
+
+    Besides the sanitizers (the harness is built with AddressSanitizer and UBSan), each run is checked
+    against the framing a client depends on, and a violation aborts with the input's output:
+
+        - the FSM settles within MAX_CALLS calls and never holds more than REQUEST_LINE_MAX
+          characters in its line buffer;
+        - the output is a sequence of responses, each opened by a 200 or 400 status line and closed
+          by the blank line after its headers;
+        - a response with a Content-Length carries exactly that many body bytes before the next
+          response, and one without it announces "Connection: close" and is the last;
+        - every dispatched request is answered, except a GET /device/events still waiting at the end;
+        - no response is written into a transmit buffer without room for it (sim_tx_stalls);
+        - the thresholds keep the band order update_config enforces, whatever a config PUT asked for.
+
+    Usage : fuzz [-r runs] [-s seed] [-o file] [-q] [file ...]
+
+    Files are run one input each (a crash or corpus entry, or AFL with "fuzz @@"). -r runs the
+    stress suite instead, after checking that each of a few malformed request lines (rejects) is
+    answered 400: 'runs' inputs of 1 to 8 pipelined requests, drawn from valid and invalid GET, PUT
+    and DELETE requests, half of them with random byte-level mutations. It reports the requests
+    parsed and answered per second of host time, the mean host time of a requestFSM call and the
+    slowest call on the simulated clock, which charges every SPI transaction and EEPROM write with
+    the cost model in sim.h and, unlike a host timer, gives the same answer on every run; -o saves
+    the input of the slowest call for replay. -q prints only failures. Built with LIBFUZZER=1
+    (clang), the harness is a libFuzzer target instead and this driver is left out.
+**/
+
+//INCLUDES:
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "socket.h"
+#include "w51.h"
+#include "vpd.h"
+#include "config.h"
+#include "log.h"
+#include "rtc.h"
+#include "parser.h"
+#include "strbuf.h"
+#include "respcache.h"
+#include "sched.h"
+#include "tempfsm.h"
+#include "samples.h"
+#include "filter.h"
+#include "alarmq.h"
+#include "stats.h"
+
+//DEFINES:
+#define FUZZ_SOCKET     0
+#define OUT_SIZE        (512 * 1024)    /* response bytes kept for the framing check */
+#define MAX_CALLS       200000          /* requestFSM calls before an input counts as stuck */
+#define MAX_BATCH       8               /* requests pipelined into one stress input */
+
+//DECLARATIONS:
+static char out[OUT_SIZE];
+static unsigned long outLen;
+static unsigned char outLost;       /* the output did not fit in 'out' */
+static unsigned long dispatched;
+static unsigned long long hostNs;   /* host time spent in requestFSM calls */
+static unsigned long long calls;    /* requestFSM calls made */
+static unsigned char quiet;
+static unsigned long rng = 12345;
+
+static const char* const seeds[] = {
+    "GET /device HTTP/1.1\r\nHost: 192.168.1.50:8080\r\n\r\n",
+    "GET /device HTTP/1.0\r\n\r\n",
+    "GET /device.bin HTTP/1.1\r\n\r\n",
+    "GET /device HTTP/1.1\r\nAccept: text/html, application/octet-stream\r\n\r\n",
+    "GET /device/log HTTP/1.1\r\n\r\n",
+    "GET /device/log?since=3&event=4,7&from=0&to=4000000000&limit=16 HTTP/1.1\r\n\r\n",
+    "GET /device/samples?since=2 HTTP/1.1\r\n\r\n",
+    "GET /device/events?since=0&state=2 HTTP/1.1\r\n\r\n",
+    "GET /device/stats HTTP/1.1\r\nConnection: keep-alive\r\n\r\n",
+    "PUT /device/config?tcrit_hi=95&twarn_hi=85&twarn_lo=60&tcrit_lo=50 HTTP/1.1\r\n\r\n",
+    "PUT /device/config?filt_median=3&filt_ema=2&filt_slew=4&filt_hyst=1 HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello",
+    "PUT /device?reset=\"false\" HTTP/1.1\r\n\r\n",
+    "PUT /device?reset=\"true\" HTTP/1.1\r\n\r\n",
+    "DELETE /device/log HTTP/1.1\r\n\r\n",
+    "GET /device/nothing HTTP/1.1\r\n\r\n",
+    "POST /device HTTP/1.1\r\n\r\n",
+    "PUT /device/config?tcrit_hi=abc&tcrit_hi=1 HTTP/1.1\r\n\r\n",
+    "PUT /device/config?tcrit_hi=-99999999999 HTTP/1.1\r\n\r\n",
+    "PUT /device/config?tcrit_lo=65535 HTTP/1.1\r\n\r\n",
+    "PUT /device/config?tcrit_hi=32767&twarn_lo=-32768 HTTP/1.1\r\n\r\n",
+    "GET /device/log?event=9&limit=0&since=99999999999 HTTP/1.1\r\n\r\n",
+    "GET /device/events?state=7 HTTP/1.1\r\n\r\n",
+    "GET /device/samples123 HTTP/1.1\r\n\r\n",
+    "GET /device/events5 HTTP/1.1\r\n\r\n",
+    "GET /device/logsince=5 HTTP/1.1\r\n\r\n",
+    "GET /device/log?since=1&since=2&since=3&since=4&since=5&since=6&since=7&since=8&since=9 HTTP/1.1\r\n\r\n",
+    "GET /device HTTP/1.1\r\nContent-Length: 99999\r\n\r\n",
+    "GET /device HTTP/1.1\r\nX-Padding: aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\r\n\r\n",
+    "\r\n\r\nGET /device HTTP/1.1\n\n",
+    //An Accept header cut off by the end of the line buffer partway through the binary type
+    "GET /device HTTP/1.1\r\nAccept: text/html, text/html, text/html, text/html, text/html, text/html, "
+        "text/html, text/html, text/html, text/html, text/html, text/html, text/c, application/octet-stream\r\n\r\n"
+};
+
+#define SEED_COUNT  (sizeof(seeds) / sizeof(seeds[0]))
+
+//Request lines the stress run checks are answered 400 before it starts
+static const char* const rejects[] = {
+    "GET /device/samples123 HTTP/1.1\r\n\r\n",
+    "GET /device/events5 HTTP/1.1\r\n\r\n",
+    "GET /device/logsince=5 HTTP/1.1\r\n\r\n",
+    "GET /device/samples?since= HTTP/1.1\r\n\r\n",
+    "GET /device/log? HTTP/1.1\r\n\r\n"
+};
+
+#define REJECT_COUNT    (sizeof(rejects) / sizeof(rejects[0]))
+
+//sim_hw.c and sim_socket.c hooks; the harness drives the socket directly
+void sim_on_idle(unsigned char s) { (void)s; }
+void sim_on_disconnect(unsigned char s) { (void)s; }
+unsigned char sim_should_stop(void) { return 0; }
+void sim_on_loop(unsigned long pass_us, unsigned long eeprom_us) { (void)pass_us; (void)eeprom_us; }
+
+void sim_on_write(unsigned char s, const char *buf, unsigned int len) {
+    (void)s;
+    if (outLen + len > OUT_SIZE) {
+        outLost = 1;
+        return;
+    }
+    memcpy(out + outLen, buf, len);
+    outLen += len;
+}
+
+static unsigned long next_random(void) {
+    rng = rng * 1103515245UL + 12345UL;
+    return ((rng >> 16) ^ (rng << 16)) & 0xFFFFFFFFUL;
+}
+
+static unsigned long elapsed_ns(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)((now.tv_sec - start->tv_sec) * 1000000000L + (now.tv_nsec - start->tv_nsec));
+}
+
+/**
+Function Name : fail
+
+Description : Reports a broken invariant with the output of the input that broke it, and aborts so
+    the fuzzer keeps the input.
+**/
+static void fail(const char *why) {
+    fprintf(stderr, "fuzz: %s\n--- output (%lu bytes) ---\n", why, outLen);
+    fwrite(out, 1, outLen, stderr);
+    fprintf(stderr, "\n---\n");
+    abort();
+}
+
+/**
+Function Name : find
+
+Description : Position of 'text' in out[from..to), or -1. The output may hold binary bodies, so
+    this does not stop at a NUL.
+**/
+static long find(unsigned long from, unsigned long to, const char *text) {
+    size_t n = strlen(text);
+    unsigned long i;
+
+    for (i = from; i + n <= to; i++) {
+        if (memcmp(out + i, text, n) == 0) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+/**
+Function Name : check_responses
+
+Description : Walks the output of one input response by response and checks its framing (see the
+    file description).
+**/
+static void check_responses(void) {
+    unsigned long pos = 0;
+    unsigned long count = 0;
+    unsigned long length;
+    long end;
+    long field;
+
+    if (outLost) {
+        return;
+    }
+    while (pos < outLen) {
+        if (outLen - pos < 17 || (memcmp(out + pos, "HTTP/1.1 200 OK\r\n", 17) != 0 &&
+                (outLen - pos < 26 || memcmp(out + pos, "HTTP/1.1 400 BAD REQUEST\r\n", 26) != 0))) {
+            fail("response does not open with a status line");
+        }
+        end = find(pos, outLen, "\r\n\r\n");
+        if (end < 0) {
+            fail("response headers are not terminated");
+        }
+        count++;
+        field = find(pos, (unsigned long)end + 2, "Content-Length: ");
+        if (field >= 0) {
+            length = strtoul(out + field + 16, NULL, 10);
+            pos = (unsigned long)end + 4;
+            if (outLen - pos < length) {
+                fail("response body is shorter than its Content-Length");
+            }
+            pos += length;
+        } else {
+            if (find(pos, (unsigned long)end + 2, "Connection: close\r\n") < 0) {
+                fail("response without a Content-Length keeps the connection open");
+            }
+            pos = outLen;
+        }
+    }
+    if (count != dispatched && !(count + 1 == dispatched && connection[FUZZ_SOCKET].phase == PHASE_WAIT)) {
+        fail("a dispatched request was not answered");
+    }
+}
+
+/**
+Function Name : init_endpoint
+
+Description : Brings the modules the request FSM uses to their power-on state, as main() does, so
+    every input starts from the same endpoint.
+**/
+static void init_endpoint(void) {
+    vpd_init();
+    config_init();
+    log_init();
+    rtc_init();
+    W5x_init();
+    tempfsm_init();
+    tempfsm_set_thresholds(config.hi_alarm, config.hi_warn, config.lo_alarm, config.lo_warn);
+    samples_init();
+    filter_init();
+    alarmq_init();
+    stats_init();
+    respcache_init();
+    sched_init();
+    samples_add(75);
+    tempfsm_update(75, config.hi_alarm, config.hi_warn, config.lo_alarm, config.lo_warn);
+    resetRequestState(FUZZ_SOCKET);
+}
+
+/**
+Function Name : run_input
+
+Description : Feeds one input to the request FSM and checks the result. Returns the simulated time
+    of the slowest requestFSM call in us.
+**/
+static unsigned long run_input(const unsigned char *data, size_t size) {
+    unsigned long long arrived;
+    unsigned long long before;
+    unsigned long n;
+    unsigned long slowest = 0;
+    unsigned char result;
+    struct timespec start;
+
+    if (size == 0) {
+        return 0;
+    }
+    init_endpoint();
+    outLen = 0;
+    outLost = 0;
+    dispatched = 0;
+    restart = 0;
+
+    sim_rtt_us = 0;
+    sim_trickle = (data[0] & 7) == 0 ? 0 : 1UL << ((data[0] & 7) - 1);
+    sim_drain = (data[0] & 0x18) == 0 ? 0 : 8UL << (3 * (((data[0] >> 3) & 3) - 1));
+    sim_tx_stalls = 0;
+    data++;
+    size--;
+    if (size > SIM_RX_SIZE) {
+        size = SIM_RX_SIZE;
+    }
+    sim_socket_inject(FUZZ_SOCKET, (const char *)data, (unsigned int)size);
+    arrived = sim_clock_us + (sim_trickle == 0 ? 0 : size * 1000ULL / sim_trickle + 1000);
+
+    for (n = 0; n < MAX_CALLS; n++) {
+        before = sim_clock_us;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        result = requestFSM(FUZZ_SOCKET);
+        hostNs += elapsed_ns(&start);
+        calls++;
+        if (sim_clock_us - before > slowest) {
+            slowest = (unsigned long)(sim_clock_us - before);
+        }
+        if (requestLine.len > REQUEST_LINE_MAX) {
+            fail("line buffer overran REQUEST_LINE_MAX");
+        }
+        if (result == FSM_DISPATCHED) {
+            dispatched++;
+        }
+        if (connection[FUZZ_SOCKET].processComplete) {
+            break;
+        }
+        if (result == FSM_IDLE) {
+            //All the input has arrived, unless an answer is still waiting for the client to read
+            if (sim_clock_us >= arrived && connection[FUZZ_SOCKET].phase != PHASE_ANSWER) {
+                break;
+            }
+            sim_advance(1000);
+        }
+    }
+    if (n == MAX_CALLS) {
+        fail("request FSM did not settle");
+    }
+    if (sim_tx_stalls != 0) {
+        fail("a response was written into a full transmit buffer");
+    }
+    if (!(config.lo_alarm < config.lo_warn && config.lo_warn < config.hi_warn &&
+            config.hi_warn < config.hi_alarm && config.hi_alarm < 0x3FF)) {
+        fail("a config PUT left the thresholds out of band order");
+    }
+    check_responses();
+    resetRequestState(FUZZ_SOCKET);
+    restart = 0;
+    return slowest;
+}
+
+#ifdef FUZZ_LIBFUZZER
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size) {
+    run_input(data, size);
+    return 0;
+}
+#else
+
+/**
+Function Name : mutate
+
+Description : Applies a few random byte-level edits to a request: flip a byte, overwrite it with a
+    character the parsers care about, delete a run, or repeat a run.
+**/
+static size_t mutate(unsigned char *buf, size_t len, size_t cap) {
+    static const char special[] = " ?&=,-0123456789\r\n\":/.";
+    int edits = 1 + (int)(next_random() % 4);
+    size_t at;
+    size_t n;
+
+    while (edits-- > 0 && len > 0) {
+        at = next_random() % len;
+        switch (next_random() % 4) {
+            case 0 :
+                buf[at] ^= (unsigned char)(1 << (next_random() % 8));
+                break;
+            case 1 :
+                buf[at] = (unsigned char)special[next_random() % (sizeof(special) - 1)];
+                break;
+            case 2 :
+                n = 1 + next_random() % 8;
+                if (n > len - at) {
+                    n = len - at;
+                }
+                memmove(buf + at, buf + at + n, len - at - n);
+                len -= n;
+                break;
+            default :
+                n = 1 + next_random() % 16;
+                if (n > len - at) {
+                    n = len - at;
+                }
+                if (len + n <= cap) {
+                    memmove(buf + at + n, buf + at, len - at);
+                    len += n;
+                }
+                break;
+        }
+    }
+    return len;
+}
+
+/**
+Function Name : make_input
+
+Description : Builds a stress input: an arrival mode byte, then 1 to MAX_BATCH pipelined requests
+    drawn from the seeds, each mutated with probability 1/2.
+**/
+static size_t make_input(unsigned char *buf, size_t cap) {
+    int batch = 1 + (int)(next_random() % MAX_BATCH);
+    size_t len = 1;
+    size_t n;
+
+    buf[0] = (unsigned char)(next_random() % 4 == 0 ? next_random() : 0);
+    while (batch-- > 0) {
+        const char *seed = seeds[next_random() % SEED_COUNT];
+        n = strlen(seed);
+        if (len + n > cap) {
+            break;
+        }
+        memcpy(buf + len, seed, n);
+        if (next_random() & 1) {
+            n = mutate(buf + len, n, cap - len);
+        }
+        len += n;
+    }
+    return len;
+}
+
+/**
+Function Name : check_rejects
+
+Description : Runs each of the rejects on its own and checks that it is answered 400.
+**/
+static void check_rejects(void) {
+    static unsigned char buf[128];
+    size_t n;
+    size_t i;
+
+    for (i = 0; i < REJECT_COUNT; i++) {
+        n = strlen(rejects[i]);
+        buf[0] = 0;
+        memcpy(buf + 1, rejects[i], n);
+        run_input(buf, n + 1);
+        if (outLen < 26 || memcmp(out, "HTTP/1.1 400 BAD REQUEST\r\n", 26) != 0) {
+            fail(rejects[i]);
+        }
+    }
+}
+
+static int run_file(const char *path) {
+    static unsigned char buf[SIM_RX_SIZE + 1];
+    unsigned long slowest;
+    size_t size;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    slowest = run_input(buf, size);
+    if (!quiet) {
+        printf("%s: %lu bytes, %lu request(s) dispatched, %lu response bytes, slowest call %lu us simulated\n",
+               path, (unsigned long)size, dispatched, outLen, slowest);
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    static unsigned char buf[SIM_RX_SIZE + 1];
+    static unsigned char worst[SIM_RX_SIZE + 1];
+    size_t worstLen = 0;
+    size_t len;
+    unsigned long runs = 0;
+    unsigned long requests = 0;
+    unsigned long input;
+    unsigned long slowest;
+    unsigned long worstUs = 0;
+    unsigned long worstInput = 0;
+    const char *save = NULL;
+    struct timespec wall;
+    double seconds;
+    int files = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            runs = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            rng = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            save = argv[++i];
+        } else if (strcmp(argv[i], "-q") == 0) {
+            quiet = 1;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [-r runs] [-s seed] [-o file] [-q] [file ...]\n", argv[0]);
+            return 1;
+        } else {
+            if (!run_file(argv[i])) {
+                return 1;
+            }
+            files++;
+        }
+    }
+    if (files > 0 && runs == 0) {
+        return 0;
+    }
+    if (runs == 0) {
+        runs = 20000;
+    }
+
+    check_rejects();
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    for (input = 0; input < runs; input++) {
+        len = make_input(buf, SIM_RX_SIZE + 1);
+        slowest = run_input(buf, len);
+        requests += dispatched;
+        if (slowest > worstUs) {
+            worstUs = slowest;
+            worstInput = input;
+            memcpy(worst, buf, len);
+            worstLen = len;
+        }
+    }
+    seconds = elapsed_ns(&wall) / 1e9;
+
+    if (!quiet) {
+        printf("stress: %lu inputs, %lu requests dispatched, %.3f s host, %.0f requests/s parsed and answered\n",
+               runs, requests, seconds, requests / seconds);
+        printf("requestFSM calls: %llu, mean %.0f ns host; slowest %lu us simulated (input %lu)\n",
+               calls, calls > 0 ? (double)hostNs / calls : 0.0, worstUs, worstInput);
+    }
+    if (save != NULL && worstLen > 0) {
+        FILE *f = fopen(save, "wb");
+        if (f == NULL) {
+            perror(save);
+            return 1;
+        }
+        fwrite(worst, 1, worstLen, f);
+        fclose(f);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,12 @@
+/**
+Description : Simulated status LED for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef LED_H_INCLUDED
+#define LED_H_INCLUDED
+
+void led_init(void);
+void led_update(void);
+void led_set_blink(char *pattern);
+
+#endif
@@ -0,0 +1,10 @@
+/**
+Description : Simulated NTP client for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef NTP_H_INCLUDED
+#define NTP_H_INCLUDED
+
+unsigned char ntp_sync_network_time(unsigned char retries);
+
+#endif
@@ -0,0 +1,13 @@
+/**
+Description : Simulated real time clock for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef RTC_H_INCLUDED
+#define RTC_H_INCLUDED
+
+void rtc_init(void);
+void rtc_set_by_datestr(char *datestr);
+unsigned long rtc_get_date(void);
+char *rtc_num2datestr(unsigned long seconds);
+
+#endif
@@ -0,0 +1,11 @@
+/**
+Description : Simulated assignment signature for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef SIGNATURE_H_INCLUDED
+#define SIGNATURE_H_INCLUDED
+
+void signature_set(char *first, char *last, char *asurite);
+void check_for_test_start(void);
+
+#endif
@@ -0,0 +1,87 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Control interface for the host-side simulation of the endpoint. The simulated
+    hardware backends (socket, temp, log, config, vpd, rtc, wdt, ...) share a simulated clock and
+    a set of per-response counters through this header, and the benchmark driver uses it to feed
+    recorded traffic into the cyclic executive and to stop the executive when the trace is done.
+**/
+#ifndef SIM_H_INCLUDED
+#define SIM_H_INCLUDED
+
+#include <setjmp.h>
+
+//DEFINES:
+#define SIM_SOCKETS         4       /* hardware sockets on the W5x */
+#define SIM_RX_SIZE         2048    /* receive buffer per socket */
+#define SIM_TX_SIZE         2048    /* transmit buffer per socket */
+
+/* SPI cost model used to advance the simulated clock (8MHz SPI, W5x framing) */
+#define SIM_SPI_XFER_US     12UL    /* address/control phase of one W5x transaction */
+#define SIM_SPI_BYTE_US     1UL     /* one data byte */
+#define SIM_LOOP_US         40UL    /* fixed cost of one pass through the cyclic executive */
+#define SIM_EEPROM_BYTE_US  3300UL  /* one EEPROM byte write */
+#define SIM_WDT_US          2000000UL   /* watchdog timeout armed by wdt_init */
+
+//DECLARATIONS:
+/* per-connection counters, reset when a client connects */
+typedef struct {
+    unsigned long spi_reads;        /* W5x receive-side transactions */
+    unsigned long spi_writes;       /* W5x transmit-side transactions */
+    unsigned long bytes_read;
+    unsigned long bytes_written;
+} sim_counters;
+
+extern unsigned long long sim_clock_us;    /* simulated time since power-on */
+extern jmp_buf sim_exit;                    /* longjmp target used to leave the executive */
+extern unsigned long sim_eeprom_writes;     /* bytes written back to EEPROM */
+extern unsigned long long sim_eeprom_us;    /* simulated time spent in EEPROM writes */
+extern unsigned long sim_alarms;            /* alarms sent to the master controller */
+extern unsigned char sim_last_alarm;        /* event code of the last alarm sent */
+extern unsigned long sim_temp_reads;        /* temperature conversions started */
+extern unsigned long sim_temp_gap_min_us;   /* shortest and longest time between two conversions */
+extern unsigned long sim_temp_gap_max_us;
+extern int sim_temperature;                 /* value returned by temp_get() */
+extern unsigned long sim_rtt_us;            /* client round trip time */
+extern unsigned long sim_trickle;           /* request arrival rate in bytes/ms, 0 for all at once */
+extern unsigned long sim_drain;             /* rate the client takes response bytes in bytes/ms, 0 for all at once */
+extern unsigned long sim_tx_stalls;         /* writes that found the transmit buffer too full */
+extern unsigned long sim_ntp_us;            /* time one NTP try takes */
+extern unsigned char sim_ntp_fail;          /* NTP tries get no answer */
+extern unsigned long sim_ntp_tries;         /* NTP tries made */
+extern unsigned long sim_wdt_max_us;        /* longest time between two watchdog resets once armed */
+extern unsigned long sim_wdt_timeouts;      /* times that exceeded SIM_WDT_US */
+
+void sim_advance(unsigned long us);     //Advance the simulated clock
+
+void sim_spi(unsigned long bytes);      //Charge one SPI transaction of 'bytes' data bytes
+
+/* callbacks implemented by the driver */
+void sim_on_idle(unsigned char s);     //Socket listening with nothing queued
+
+void sim_on_disconnect(unsigned char s);   //Server closed a connection
+
+void sim_on_write(unsigned char s, const char *buf, unsigned int len);   //Server wrote response bytes
+
+unsigned char sim_should_stop(void);    //True once the trace has been replayed
+
+void sim_on_loop(unsigned long pass_us, unsigned long eeprom_us);    //One pass of the executive, and its EEPROM share
+
+/* socket backend hooks used by the driver */
+void sim_socket_inject(unsigned char s, const char *buf, unsigned int len);  //Client connects and sends
+
+void sim_socket_send(unsigned char s, const char *buf, unsigned int len);    //Client sends on an open connection
+
+void sim_socket_client_close(unsigned char s);  //Client closes its side of the connection
+
+sim_counters *sim_socket_counters(unsigned char s);     //Counters for the current connection
+
+#endif
@@ -0,0 +1,286 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Simulated board peripherals for the host build: the shared simulated clock, delay
+    slots, watchdog, temperature sensor, RTC, UART, LED, SPI, DHCP, NTP, alarms and the
+    assignment signature. Peripherals that only produce side effects on the board are reduced
+    to counters the benchmark driver can report.
+**/
+
+//INCLUDES:
+#include <stdio.h>
+#include "delay.h"
+#include "wdt.h"
+#include "temp.h"
+#include "rtc.h"
+#include "uart.h"
+#include "led.h"
+#include "spi.h"
+#include "dhcp.h"
+#include "ntp.h"
+#include "alarm.h"
+#include "signature.h"
+#include "socket.h"
+#include "sim.h"
+
+//DEFINES:
+#define DELAY_SLOTS     4
+#define NTP_TIME        1602720000UL    /* 10/15/2020 00:00:00, time handed out by the simulated NTP server */
+
+//DECLARATIONS:
+unsigned long long sim_clock_us;
+jmp_buf sim_exit;
+unsigned long sim_eeprom_writes;
+unsigned long long sim_eeprom_us;
+int sim_temperature = 75;
+unsigned long sim_alarms;
+unsigned char sim_last_alarm;
+unsigned long sim_temp_reads;
+unsigned long sim_temp_gap_min_us;
+unsigned long sim_temp_gap_max_us;
+unsigned long sim_ntp_us = 400000UL;
+unsigned char sim_ntp_fail;
+unsigned long sim_ntp_tries;
+unsigned long sim_wdt_max_us;
+unsigned long sim_wdt_timeouts;
+
+static unsigned long long delay_start[DELAY_SLOTS];
+static unsigned long long delay_end[DELAY_SLOTS];
+static unsigned long rtc_base;
+static unsigned long long rtc_base_us;
+static unsigned char local_ip[4] = {192, 168, 1, 50};
+static unsigned char gateway_ip[4] = {192, 168, 1, 1};
+static unsigned char subnet_mask[4] = {255, 255, 255, 0};
+static char datestr[32];
+static unsigned char wdt_armed;
+static unsigned long long wdt_last_us;
+
+void sim_advance(unsigned long us) {
+    sim_clock_us += us;
+}
+
+void sim_spi(unsigned long bytes) {
+    sim_advance(SIM_SPI_XFER_US + bytes * SIM_SPI_BYTE_US);
+}
+
+//DELAY:
+void delay_set(unsigned int num, unsigned int time) {
+    delay_start[num] = sim_clock_us;
+    delay_end[num] = sim_clock_us + (unsigned long long)time * 1000ULL;
+}
+
+unsigned char delay_isdone(unsigned int num) {
+    return sim_clock_us >= delay_end[num];
+}
+
+/* As on the board, the count runs up from delay_set and stops at the limit delay_isdone checks. */
+unsigned int delay_get(unsigned int num) {
+    if (sim_clock_us >= delay_end[num]) {
+        return (unsigned int)((delay_end[num] - delay_start[num]) / 1000ULL);
+    }
+    return (unsigned int)((sim_clock_us - delay_start[num]) / 1000ULL);
+}
+
+//WATCHDOG:
+/* the watchdog does not restart the simulation; a reset that comes too late is counted instead */
+void wdt_init(void) {
+    wdt_armed = 1;
+    wdt_last_us = sim_clock_us;
+}
+
+static void wdt_kick(void) {
+    if (wdt_armed) {
+        if (sim_clock_us - wdt_last_us > sim_wdt_max_us) {
+            sim_wdt_max_us = (unsigned long)(sim_clock_us - wdt_last_us);
+        }
+        if (sim_clock_us - wdt_last_us > SIM_WDT_US) {
+            sim_wdt_timeouts++;
+        }
+        wdt_last_us = sim_clock_us;
+    }
+}
+
+/* Called once per pass of the cyclic executive, so it also charges the loop overhead and is
+ * where the simulation leaves the executive once the driver has replayed its trace. The reset
+ * ../boot.c makes before a blocking NTP try is counted as a pass of its own. */
+void wdt_reset(void) {
+    static unsigned long long last_pass;
+    static unsigned long long last_eeprom;
+    wdt_kick();
+    sim_advance(SIM_LOOP_US);
+    if (last_pass != 0) {
+        sim_on_loop((unsigned long)(sim_clock_us - last_pass), (unsigned long)(sim_eeprom_us - last_eeprom));
+    }
+    last_pass = sim_clock_us;
+    last_eeprom = sim_eeprom_us;
+    if (sim_should_stop()) {
+        longjmp(sim_exit, 1);
+    }
+}
+
+/* a reset drops every open connection before the executive starts over */
+void wdt_force_restart(void) {
+    unsigned char s;
+    for (s = 0; s < SIM_SOCKETS; s++) {
+        socket_disconnect(s);
+    }
+    longjmp(sim_exit, 2);
+}
+
+//TEMPERATURE:
+/* the interval into the first periodic conversion after a boot is the startup delay, not the cadence */
+static unsigned char temp_starts_since_init;
+
+void temp_init(void) {
+    temp_starts_since_init = 0;
+}
+
+/* records the interval between periodic conversions, to check the sampling cadence under load */
+void temp_start(void) {
+    static unsigned long long last_start;
+    unsigned long gap = (unsigned long)(sim_clock_us - last_start);
+    if (temp_starts_since_init < 2) {
+        temp_starts_since_init++;
+    } else {
+        if (sim_temp_gap_min_us == 0 || gap < sim_temp_gap_min_us) {
+            sim_temp_gap_min_us = gap;
+        }
+        if (gap > sim_temp_gap_max_us) {
+            sim_temp_gap_max_us = gap;
+        }
+    }
+    last_start = sim_clock_us;
+    sim_temp_reads++;
+}
+
+unsigned char temp_is_data_ready(void) {
+    return 1;
+}
+
+int temp_get(void) {
+    return sim_temperature;
+}
+
+//RTC:
+void rtc_init(void) {
+    rtc_base = 0;
+    rtc_base_us = sim_clock_us;
+}
+
+/* Takes the "MM/DD/YYYY HH:MM:SS" form rtc_num2datestr returns; anything else leaves the clock alone. */
+void rtc_set_by_datestr(char *str) {
+    static const unsigned short mstart[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    unsigned int month, day, year, hour, minute, second;
+    unsigned long days;
+    unsigned int y;
+
+    if (sscanf(str, "%u/%u/%u %u:%u:%u", &month, &day, &year, &hour, &minute, &second) != 6 ||
+        month < 1 || month > 12 || year < 1970) {
+        return;
+    }
+    days = mstart[month - 1] + day - 1;
+    if (month > 2 && (year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0)) {
+        days++;
+    }
+    for (y = 1970; y < year; y++) {
+        days += ((y % 4) == 0 && ((y % 100) != 0 || (y % 400) == 0)) ? 366 : 365;
+    }
+    rtc_base = days * 86400UL + hour * 3600UL + minute * 60UL + second;
+    rtc_base_us = sim_clock_us;
+}
+
+unsigned long rtc_get_date(void) {
+    return rtc_base + (unsigned long)((sim_clock_us - rtc_base_us) / 1000000ULL);
+}
+
+/* Same year/month walk as the board RTC library, including its cost profile. */
+char *rtc_num2datestr(unsigned long seconds) {
+    static const unsigned char mdays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    unsigned long days = seconds / 86400UL;
+    unsigned long rem = seconds % 86400UL;
+    unsigned int year = 1970;
+    unsigned char month = 0;
+
+    for (;;) {
+        unsigned int ylen = ((year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0)) ? 366 : 365;
+        if (days < ylen) {
+            break;
+        }
+        days -= ylen;
+        year++;
+    }
+    for (;;) {
+        unsigned char mlen = mdays[month];
+        if (month == 1 && (year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0)) {
+            mlen = 29;
+        }
+        if (days < mlen) {
+            break;
+        }
+        days -= mlen;
+        month++;
+    }
+    snprintf(datestr, sizeof(datestr), "%02u/%02lu/%04u %02lu:%02lu:%02lu",
+             month + 1, days + 1, year, rem / 3600UL, (rem / 60UL) % 60UL, rem % 60UL);
+    return datestr;
+}
+
+//UART:
+void uart_init(void) {}
+void uart_writechar(char c) { (void)c; }
+void uart_writestr(char *str) { (void)str; }
+void uart_writedec32(long value) { (void)value; }
+void uart_writeip(unsigned char *ip) { (void)ip; }
+
+//LED / SPI:
+void led_init(void) {}
+void led_update(void) {}
+void led_set_blink(char *pattern) { (void)pattern; }
+void spi_init(void) {}
+
+//DHCP / NTP:
+unsigned char dhcp_start(unsigned char *mac, unsigned long timeout, unsigned long responseTimeout) {
+    (void)mac; (void)timeout; (void)responseTimeout;
+    sim_advance(250000UL);
+    return 1;
+}
+
+unsigned char *dhcp_getLocalIp(void) { return local_ip; }
+unsigned char *dhcp_getGatewayIp(void) { return gateway_ip; }
+unsigned char *dhcp_getSubnetMask(void) { return subnet_mask; }
+
+/* each try takes sim_ntp_us, and with sim_ntp_fail gets no answer, like a server that is down */
+unsigned char ntp_sync_network_time(unsigned char retries) {
+    while (retries-- > 0) {
+        sim_ntp_tries++;
+        sim_advance(sim_ntp_us);
+        if (!sim_ntp_fail) {
+            rtc_base = NTP_TIME;
+            rtc_base_us = sim_clock_us;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//ALARM / SIGNATURE:
+void alarm_send(unsigned char event) {
+    sim_alarms++;
+    sim_last_alarm = event;
+    /* UDP send to the master controller */
+    sim_spi(32);
+}
+
+void signature_set(char *first, char *last, char *asurite) {
+    (void)first; (void)last; (void)asurite;
+}
+
+void check_for_test_start(void) {}
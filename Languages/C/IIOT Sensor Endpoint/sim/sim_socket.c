@@ -0,0 +1,364 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Simulated W5x socket layer. Each hardware socket has a receive buffer that the
+    benchmark driver fills with recorded client traffic. Every call that would touch the W5x
+    over SPI is charged to the simulated clock and counted per socket so the driver can report
+    SPI reads/writes per response.
+
+    Each socket also has a transmit buffer of SIM_TX_SIZE bytes, which the client drains at
+    sim_drain bytes per ms of simulated time. socket_send_available reports the room left in it. A
+    write that does not fit waits for the client as the board library does, stalling the executive;
+    the simulated clock is advanced until it fits, and the stall is counted in sim_tx_stalls.
+**/
+
+//INCLUDES:
+#include <string.h>
+#include <stdio.h>
+#include "socket.h"
+#include "rtc.h"
+#include "w51.h"
+#include "sim.h"
+
+//DEFINES:
+#define SOCK_CLOSED         0
+#define SOCK_INIT           1
+#define SOCK_LISTEN         2
+#define SOCK_ESTABLISHED    3
+#define SOCK_CLOSE_WAIT     4       /* the client has closed its side */
+
+//DECLARATIONS:
+typedef struct {
+    unsigned char state;
+    unsigned int port;
+    char rx[SIM_RX_SIZE];
+    unsigned int rxlen;
+    unsigned int rxpos;
+    unsigned long long rx_ready;    /* simulated time the request bytes arrive */
+    unsigned int txlen;             /* response bytes the client has not taken yet */
+    unsigned long long tx_time;     /* simulated time txlen was last brought up to date */
+    sim_counters counters;
+} sim_socket;
+
+unsigned long sim_rtt_us = 1000;
+unsigned long sim_trickle = 0;
+unsigned long sim_drain = 1000;
+unsigned long sim_tx_stalls = 0;
+
+static sim_socket sockets[SIM_SOCKETS];
+
+/**
+Function Name : rx_end
+
+Description : End of the part of the receive buffer that has arrived. Requests become visible one
+    round trip after the connect; with a trickle rate set (bytes per ms) they then arrive gradually.
+**/
+static unsigned int rx_end(SOCKET s) {
+    unsigned long long arrived;
+    if (sim_clock_us < sockets[s].rx_ready) {
+        return sockets[s].rxpos;
+    }
+    if (sim_trickle == 0) {
+        return sockets[s].rxlen;
+    }
+    arrived = (sim_clock_us - sockets[s].rx_ready) * sim_trickle / 1000ULL + 1;
+    return arrived < sockets[s].rxlen ? (unsigned int)arrived : sockets[s].rxlen;
+}
+
+/**
+Function Name : tx_drain
+
+Description : Takes out of the transmit buffer what the client has read since the last call. A
+    sim_drain of 0 is a client that takes everything at once.
+**/
+static void tx_drain(SOCKET s) {
+    unsigned long long drained = (sim_clock_us - sockets[s].tx_time) * sim_drain / 1000ULL;
+    if (sim_drain == 0) {
+        sockets[s].txlen = 0;
+    } else if (drained > 0) {
+        sockets[s].txlen = drained < sockets[s].txlen ? sockets[s].txlen - (unsigned int)drained : 0;
+        sockets[s].tx_time = sim_clock_us;
+    }
+    if (sockets[s].txlen == 0) {
+        sockets[s].tx_time = sim_clock_us;
+    }
+}
+
+/**
+Function Name : charge_read / charge_write
+
+Description : Account for one W5x receive or transmit transaction of 'bytes' data bytes.
+**/
+static void charge_read(SOCKET s, unsigned long bytes) {
+    sockets[s].counters.spi_reads++;
+    sockets[s].counters.bytes_read += bytes;
+    sim_spi(bytes);
+}
+
+static void charge_write(SOCKET s, const char *buf, unsigned int len) {
+    tx_drain(s);
+    if (len > SIM_TX_SIZE - sockets[s].txlen) {
+        sim_tx_stalls++;
+        sim_advance((unsigned long)((len - (SIM_TX_SIZE - sockets[s].txlen)) * 1000ULL / sim_drain) + 1);
+        tx_drain(s);
+    }
+    sockets[s].txlen = len < SIM_TX_SIZE - sockets[s].txlen ? sockets[s].txlen + len : SIM_TX_SIZE;
+    sockets[s].counters.spi_writes++;
+    sockets[s].counters.bytes_written += len;
+    /* data phase plus the SEND command that pushes it onto the wire */
+    sim_spi(len);
+    sim_spi(1);
+    sim_on_write(s, buf, len);
+}
+
+/**
+Function Name : sim_socket_inject
+
+Description : Called by the driver to connect a client to a listening socket and place its
+    request bytes in the receive buffer. The bytes only become visible to the server one network
+    round trip (sim_rtt_us, for the TCP handshake) after the connect. Resets the connection counters.
+**/
+void sim_socket_inject(SOCKET s, const char *buf, unsigned int len) {
+    if (len > SIM_RX_SIZE) {
+        len = SIM_RX_SIZE;
+    }
+    memcpy(sockets[s].rx, buf, len);
+    sockets[s].rxlen = len;
+    sockets[s].rxpos = 0;
+    sockets[s].rx_ready = sim_clock_us + sim_rtt_us;
+    sockets[s].txlen = 0;
+    sockets[s].state = SOCK_ESTABLISHED;
+    memset(&sockets[s].counters, 0, sizeof(sim_counters));
+}
+
+/**
+Function Name : sim_socket_send
+
+Description : Called by the driver when a client sends more requests on a connection that is already
+    established. Whatever the server has not read yet is kept; the new bytes are appended and become
+    visible half a round trip later.
+**/
+void sim_socket_send(SOCKET s, const char *buf, unsigned int len) {
+    sim_socket *sock = &sockets[s];
+
+    memmove(sock->rx, sock->rx + sock->rxpos, sock->rxlen - sock->rxpos);
+    sock->rxlen -= sock->rxpos;
+    sock->rxpos = 0;
+    if (sock->rxlen == 0) {
+        sock->rx_ready = sim_clock_us + sim_rtt_us / 2;
+    }
+    if (len > SIM_RX_SIZE - sock->rxlen) {
+        len = SIM_RX_SIZE - sock->rxlen;
+    }
+    memcpy(sock->rx + sock->rxlen, buf, len);
+    sock->rxlen += len;
+}
+
+/**
+Function Name : sim_socket_client_close
+
+Description : Called by the driver when a client closes its side of a connection. The server sees the
+    socket leave the established state and is expected to disconnect it.
+**/
+void sim_socket_client_close(SOCKET s) {
+    if (sockets[s].state == SOCK_ESTABLISHED) {
+        sockets[s].state = SOCK_CLOSE_WAIT;
+    }
+}
+
+sim_counters *sim_socket_counters(SOCKET s) {
+    return &sockets[s].counters;
+}
+
+void W5x_init(void) {
+    memset(sockets, 0, sizeof(sockets));
+}
+
+void W5x_config(unsigned char *mac, unsigned char *ip, unsigned char *gateway, unsigned char *subnet) {
+    (void)mac; (void)ip; (void)gateway; (void)subnet;
+    sim_spi(18);
+}
+
+void socket_open(SOCKET s, unsigned int port) {
+    sim_spi(3);
+    sockets[s].state = SOCK_INIT;
+    sockets[s].port = port;
+    sockets[s].rxlen = 0;
+    sockets[s].rxpos = 0;
+    sockets[s].txlen = 0;
+}
+
+void socket_listen(SOCKET s) {
+    sim_spi(1);
+    if (sockets[s].state == SOCK_INIT) {
+        sockets[s].state = SOCK_LISTEN;
+    }
+}
+
+void socket_disconnect(SOCKET s) {
+    sim_spi(1);
+    if (sockets[s].state == SOCK_ESTABLISHED || sockets[s].state == SOCK_CLOSE_WAIT) {
+        sockets[s].state = SOCK_CLOSED;
+        sim_on_disconnect(s);
+    }
+    sockets[s].state = SOCK_CLOSED;
+}
+
+void socket_close(SOCKET s) {
+    socket_disconnect(s);
+}
+
+unsigned char socket_is_closed(SOCKET s) {
+    sim_spi(1);
+    return sockets[s].state == SOCK_CLOSED;
+}
+
+unsigned char socket_is_listening(SOCKET s) {
+    sim_spi(1);
+    return sockets[s].state == SOCK_LISTEN;
+}
+
+unsigned char socket_is_established(SOCKET s) {
+    sim_spi(1);
+    return sockets[s].state == SOCK_ESTABLISHED;
+}
+
+unsigned int socket_recv_available(SOCKET s) {
+    /* a listening socket is where a new client shows up */
+    if (sockets[s].state == SOCK_LISTEN) {
+        sim_on_idle(s);
+    }
+    charge_read(s, 2);
+    return rx_end(s) - sockets[s].rxpos;
+}
+
+unsigned char socket_received_line(SOCKET s) {
+    unsigned int i;
+    charge_read(s, rx_end(s) - sockets[s].rxpos);
+    for (i = sockets[s].rxpos; i < rx_end(s); i++) {
+        if (sockets[s].rx[i] == '\n') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+unsigned char socket_peek(SOCKET s) {
+    charge_read(s, 1);
+    if (sockets[s].rxpos >= rx_end(s)) {
+        return 0;
+    }
+    return (unsigned char)sockets[s].rx[sockets[s].rxpos];
+}
+
+unsigned int socket_recv(SOCKET s, unsigned char *buf, unsigned int len) {
+    unsigned int avail = rx_end(s) - sockets[s].rxpos;
+    if (len > avail) {
+        len = avail;
+    }
+    charge_read(s, len);
+    memcpy(buf, sockets[s].rx + sockets[s].rxpos, len);
+    sockets[s].rxpos += len;
+    return len;
+}
+
+unsigned char socket_recv_compare(SOCKET s, char *str) {
+    unsigned int len = (unsigned int)strlen(str);
+    unsigned int avail = rx_end(s) - sockets[s].rxpos;
+
+    charge_read(s, len < avail ? len : avail);
+    if (len > avail || memcmp(sockets[s].rx + sockets[s].rxpos, str, len) != 0) {
+        return 0;
+    }
+    sockets[s].rxpos += len;
+    return 1;
+}
+
+unsigned char socket_recv_int(SOCKET s, int *value) {
+    int result = 0;
+    int sign = 1;
+    unsigned char digits = 0;
+
+    if (sockets[s].rxpos < rx_end(s) && sockets[s].rx[sockets[s].rxpos] == '-') {
+        charge_read(s, 1);
+        sign = -1;
+        sockets[s].rxpos++;
+    }
+    while (sockets[s].rxpos < rx_end(s)) {
+        char c = sockets[s].rx[sockets[s].rxpos];
+        charge_read(s, 1);
+        if (c < '0' || c > '9') {
+            break;
+        }
+        result = result * 10 + (c - '0');
+        sockets[s].rxpos++;
+        digits++;
+    }
+    *value = sign * result;
+    return digits != 0;
+}
+
+void socket_flush_line(SOCKET s) {
+    unsigned int start = sockets[s].rxpos;
+    while (sockets[s].rxpos < rx_end(s)) {
+        if (sockets[s].rx[sockets[s].rxpos++] == '\n') {
+            break;
+        }
+    }
+    charge_read(s, sockets[s].rxpos - start);
+}
+
+unsigned int socket_send_available(SOCKET s) {
+    sim_spi(2);
+    tx_drain(s);
+    return SIM_TX_SIZE - sockets[s].txlen;
+}
+
+void socket_writebuf(SOCKET s, unsigned char *buf, unsigned int len) {
+    charge_write(s, (const char *)buf, len);
+}
+
+void socket_writestr(SOCKET s, char *str) {
+    charge_write(s, str, (unsigned int)strlen(str));
+}
+
+void socket_writechar(SOCKET s, char c) {
+    charge_write(s, &c, 1);
+}
+
+void socket_writequotedstring(SOCKET s, char *str) {
+    char buf[SIM_RX_SIZE];
+    int len = snprintf(buf, sizeof(buf), "\"%s\"", str);
+    charge_write(s, buf, (unsigned int)len);
+}
+
+void socket_writedec32(SOCKET s, long value) {
+    char buf[12];
+    int len = snprintf(buf, sizeof(buf), "%ld", value);
+    charge_write(s, buf, (unsigned int)len);
+}
+
+void socket_writehex8(SOCKET s, unsigned char value) {
+    char buf[3];
+    snprintf(buf, sizeof(buf), "%02X", value);
+    charge_write(s, buf, 2);
+}
+
+void socket_writedate(SOCKET s, unsigned long seconds) {
+    socket_writequotedstring(s, rtc_num2datestr(seconds));
+}
+
+void socket_write_macaddress(SOCKET s, unsigned char *mac) {
+    char buf[20];
+    int len = snprintf(buf, sizeof(buf), "\"%02X:%02X:%02X:%02X:%02X:%02X\"",
+                       mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    charge_write(s, buf, (unsigned int)len);
+}
@@ -0,0 +1,85 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Simulated EEPROM-backed stores for the host build: the EEPROM driver and the VPD and
+    config blocks (the event log and the temperature FSM are the endpoint's own log.c and tempfsm.c).
+    Write-backs are charged to the simulated clock at EEPROM byte-write speed and counted in
+    sim_eeprom_writes.
+**/
+
+//INCLUDES:
+#include <string.h>
+#include "eeprom.h"
+#include "vpd.h"
+#include "config.h"
+#include "sim.h"
+
+//DEFINES:
+#define EEPROM_SIZE     1024
+#define CONFIG_ADDR     0x040
+
+//DECLARATIONS:
+vpd_struct vpd;
+config_struct config;
+
+static unsigned char eeprom[EEPROM_SIZE];
+static unsigned char config_modified;
+
+//EEPROM:
+void eeprom_writebuf(unsigned int addr, unsigned char *buf, unsigned char size) {
+    memcpy(eeprom + addr, buf, size);
+    sim_eeprom_writes += size;
+    sim_eeprom_us += size * SIM_EEPROM_BYTE_US;
+    sim_advance(size * SIM_EEPROM_BYTE_US);
+}
+
+void eeprom_readbuf(unsigned int addr, unsigned char *buf, unsigned char size) {
+    memcpy(buf, eeprom + addr, size);
+}
+
+unsigned char eeprom_isbusy(void) {
+    return 0;
+}
+
+//VPD:
+void vpd_init(void) {
+    static const unsigned char mac[6] = {0x00, 0x1E, 0xC0, 0x4A, 0x12, 0x7B};
+    memset(&vpd, 0, sizeof(vpd));
+    memcpy(vpd.token, "SER", 4);
+    strcpy(vpd.model, "TEMPSENS1");
+    strcpy(vpd.manufacturer, "Bugai");
+    strcpy(vpd.serial_number, "SN00042");
+    vpd.manufacture_date = 1601510400UL;
+    memcpy(vpd.mac_address, mac, 6);
+    strcpy(vpd.country_of_origin, "USA");
+}
+
+//CONFIG:
+void config_init(void) {
+    memset(&config, 0, sizeof(config));
+    memcpy(config.token, "ASU", 4);
+    config.hi_alarm = 90;
+    config.hi_warn = 80;
+    config.lo_alarm = 40;
+    config.lo_warn = 50;
+    config_modified = 0;
+}
+
+void config_set_modified(void) {
+    config_modified = 1;
+}
+
+void config_update(void) {
+    if (config_modified) {
+        eeprom_writebuf(CONFIG_ADDR, (unsigned char *)&config, sizeof(config));
+        config_modified = 0;
+    }
+}
@@ -0,0 +1,80 @@
+# Summarizes `size -A` output for the objects of the size report, one line per module, then the
+# common variables from `nm -S` (the second input): those defined in a header, like connection[] in
+# parser.h, belong to no one module and are counted once on their own line.
+#
+# code     .text: instructions
+# progmem  .progmem*: tables and strings kept in flash (PROGMEM, PSTR)
+# data     .data and .rodata*: initialized variables and constants, which the AVR copies from flash
+#          into SRAM at start-up
+# bss      .bss and common: zeroed variables
+# flash    code + progmem + data
+# sram     data + bss, before the stack
+#
+# Built on the host (no avr-gcc), code is host instructions and pointers in tables take 8 bytes,
+# but the split between the columns is the one the AVR build would have.
+#
+# The total sram must leave 'reserve' bytes of the MCU's 'sram' for the board library and the stack;
+# if it does not, the report ends with an error and a non-zero exit when 'check' is "error", or
+# with a warning otherwise (the host build, whose figures overstate the AVR's).
+
+function row(name, c, p, d, b) {
+    printf "%-16s %7d %7d %7d %7d %7d %7d\n", name, c, p, d, b, c + p + d, d + b
+}
+
+function hex(text,    i, n) {
+    n = 0
+    for (i = 1; i <= length(text); i++) {
+        n = n * 16 + index("0123456789abcdef", tolower(substr(text, i, 1))) - 1
+    }
+    return n
+}
+
+function flush() {
+    if (module != "") {
+        row(module, code, progmem, data, bss)
+        tc += code; tp += progmem; td += data; tb += bss
+    }
+    code = progmem = data = bss = 0
+}
+
+BEGIN {
+    printf "%-16s %7s %7s %7s %7s %7s %7s\n", "module", "code", "progmem", "data", "bss", "flash", "sram"
+}
+
+FILENAME != "-" {
+    flush()
+    module = ""
+    if ($3 == "C" && !($4 in seen)) {
+        seen[$4] = 1
+        common += hex($2)
+    }
+    next
+}
+
+/ :$/ {
+    flush()
+    module = $1
+    sub(/.*\//, "", module)
+    sub(/\.o$/, "", module)
+    next
+}
+
+$1 ~ /^\.text/                  { code += $2 }
+$1 ~ /^\.progmem/               { progmem += $2 }
+$1 ~ /^\.(data|rodata)/         { data += $2 }
+$1 ~ /^(\.bss|COMMON)/          { bss += $2 }
+
+END {
+    row("(common)", 0, 0, 0, common)
+    row("total", tc, tp, td, tb + common)
+
+    used = td + tb + common
+    printf "sram %d + reserve %d of %d on the %s\n", used, reserve, sram, mcu
+    if (used + reserve > sram) {
+        if (check == "error") {
+            printf "error: static SRAM is %d bytes over the budget\n", used + reserve - sram > "/dev/stderr"
+            exit 1
+        }
+        printf "warning: static SRAM is %d bytes over the budget (host sizes)\n", used + reserve - sram > "/dev/stderr"
+    }
+}
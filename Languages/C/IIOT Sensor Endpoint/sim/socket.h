@@ -0,0 +1,36 @@
+/**
+Description : Simulated W5x socket interface for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef SOCKET_H_INCLUDED
+#define SOCKET_H_INCLUDED
+
+#define SOCKET unsigned char
+
+void socket_open(SOCKET s, unsigned int port);
+void socket_listen(SOCKET s);
+void socket_disconnect(SOCKET s);
+void socket_close(SOCKET s);
+unsigned char socket_is_closed(SOCKET s);
+unsigned char socket_is_listening(SOCKET s);
+unsigned char socket_is_established(SOCKET s);
+
+unsigned int socket_recv_available(SOCKET s);
+unsigned char socket_received_line(SOCKET s);
+unsigned char socket_peek(SOCKET s);
+unsigned int socket_recv(SOCKET s, unsigned char *buf, unsigned int len);
+unsigned char socket_recv_compare(SOCKET s, char *str);
+unsigned char socket_recv_int(SOCKET s, int *value);
+void socket_flush_line(SOCKET s);
+
+unsigned int socket_send_available(SOCKET s);
+void socket_writebuf(SOCKET s, unsigned char *buf, unsigned int len);
+void socket_writestr(SOCKET s, char *str);
+void socket_writechar(SOCKET s, char c);
+void socket_writequotedstring(SOCKET s, char *str);
+void socket_writedec32(SOCKET s, long value);
+void socket_writehex8(SOCKET s, unsigned char value);
+void socket_writedate(SOCKET s, unsigned long seconds);
+void socket_write_macaddress(SOCKET s, unsigned char *mac);
+
+#endif
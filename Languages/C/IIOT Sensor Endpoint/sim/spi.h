@@ -0,0 +1,10 @@
+/**
+Description : Simulated SPI bus for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef SPI_H_INCLUDED
+#define SPI_H_INCLUDED
+
+void spi_init(void);
+
+#endif
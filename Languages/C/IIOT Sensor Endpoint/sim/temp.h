@@ -0,0 +1,13 @@
+/**
+Description : Simulated temperature sensor for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef TEMP_H_INCLUDED
+#define TEMP_H_INCLUDED
+
+void temp_init(void);
+void temp_start(void);
+int temp_get(void);
+unsigned char temp_is_data_ready(void);
+
+#endif
@@ -0,0 +1,14 @@
+/**
+Description : Simulated UART console for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef UART_H_INCLUDED
+#define UART_H_INCLUDED
+
+void uart_init(void);
+void uart_writechar(char c);
+void uart_writestr(char *str);
+void uart_writedec32(long value);
+void uart_writeip(unsigned char *ip);
+
+#endif
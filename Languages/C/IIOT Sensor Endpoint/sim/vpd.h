@@ -0,0 +1,23 @@
+/**
+Description : Simulated vital product data block for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef VPD_H_INCLUDED
+#define VPD_H_INCLUDED
+
+typedef struct {
+    char token[4];
+    char model[12];
+    char manufacturer[12];
+    char serial_number[12];
+    unsigned long manufacture_date;
+    unsigned char mac_address[6];
+    char country_of_origin[4];
+    unsigned char checksum;
+} vpd_struct;
+
+extern vpd_struct vpd;
+
+void vpd_init(void);
+
+#endif
@@ -0,0 +1,11 @@
+/**
+Description : Simulated W5x ethernet controller for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef W51_H_INCLUDED
+#define W51_H_INCLUDED
+
+void W5x_init(void);
+void W5x_config(unsigned char *mac, unsigned char *ip, unsigned char *gateway, unsigned char *subnet);
+
+#endif
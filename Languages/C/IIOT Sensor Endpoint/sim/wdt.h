@@ -0,0 +1,12 @@
+/**
+Description : Simulated watchdog timer for the host build of the endpoint. Mirrors the
+    interface of the board support library so main.c and parser.c compile unchanged.
+**/
+#ifndef WDT_H_INCLUDED
+#define WDT_H_INCLUDED
+
+void wdt_init(void);
+void wdt_reset(void);
+void wdt_force_restart(void);
+
+#endif
@@ -0,0 +1,308 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Run-time counters and timers. Nothing used to record how the endpoint behaves under
+    load, so a slow pass, a burst of 400s or a run of EEPROM writes could only be found by
+    reproducing it on the bench. The hot paths now count into fixed slots here: requests by type and
+    400 responses (parser.c), and the log records, log bytes and config blocks written back to EEPROM
+    (log.c, writeback.c). Each counter is an add to a static array, and GET /device/stats reads
+    them all back.
+
+    Timers keep the shortest and longest run and a histogram of run times in power-of-two
+    millisecond buckets, so the distribution can be compared between builds without storing any
+    samples. They run on the scheduler clock (see sched_now), as the board library offers no
+    free-running timer finer than its millisecond delay slots. A pass of the executive normally
+    takes well under a millisecond and lands in the first bucket, or the second when it spans a
+    tick of the clock; the buckets above them show the passes that stalled. The watchdog margin
+    reported is STATS_WDT_TIMEOUT_MS less the longest pass, since the watchdog is reset once per
+    pass. wdt.h does not export the timeout wdt_init programs, so STATS_WDT_TIMEOUT_MS restates the
+    board library's 2 s and must be changed with it.
+
+    The counters and timers are zeroed at power-on and on a restart, and roll over silently.
+**/
+
+//INCLUDES:
+#include "strbuf.h"
+#include "sched.h"
+#include "alarmq.h"
+#include "stats.h"
+#include "progmem.h"
+
+//DECLARATIONS:
+typedef struct {
+    unsigned int min;                       //Shortest run in ms, or 0xFFFF before the first
+    unsigned int max;                       //Longest run in ms
+    unsigned long bucket[STATS_BUCKETS];    //Runs by time: 0, 1, 2-3, 4-7, ... ms
+} statsTimer;
+
+//Member names of the counters and timers, in program memory
+static const char getName[] PROGMEM = "get";
+static const char binName[] PROGMEM = "bin";
+static const char logName[] PROGMEM = "log";
+static const char samplesName[] PROGMEM = "samples";
+static const char eventsName[] PROGMEM = "events";
+static const char statsName[] PROGMEM = "stats";
+static const char configName[] PROGMEM = "config";
+static const char resetName[] PROGMEM = "reset";
+static const char deleteName[] PROGMEM = "delete";
+static const char invalidName[] PROGMEM = "invalid";
+static const char badRequestsName[] PROGMEM = "bad_requests";
+static const char logRecordsName[] PROGMEM = "log_records";
+static const char logBytesName[] PROGMEM = "log_bytes";
+static const char configWritesName[] PROGMEM = "config_writes";
+static const char loopName[] PROGMEM = "loop";
+static const char fsmName[] PROGMEM = "fsm";
+static const char* const counterName[STATS_COUNTERS] PROGMEM = {
+    getName, binName, logName, samplesName, eventsName, statsName, configName, resetName, deleteName,
+    invalidName, badRequestsName, logRecordsName, logBytesName, configWritesName
+};
+static const char* const timerName[STATS_TIMERS] PROGMEM = {loopName, fsmName};
+
+static unsigned long counter[STATS_COUNTERS];
+static statsTimer timer[STATS_TIMERS];
+static unsigned long lastPass;      //sched_now() at the end of the last pass
+static unsigned char passing;       //A pass has ended since init
+
+/**
+Function Name : stats_init
+
+Description : Zeroes every counter and timer.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Stats - The counters and timers are cleared.
+**/
+void stats_init(void) {
+    unsigned char i;
+    unsigned char j;
+
+    for (i = 0; i < STATS_COUNTERS; i++) {
+        counter[i] = 0;
+    }
+    for (i = 0; i < STATS_TIMERS; i++) {
+        timer[i].min = 0xFFFF;
+        timer[i].max = 0;
+        for (j = 0; j < STATS_BUCKETS; j++) {
+            timer[i].bucket[j] = 0;
+        }
+    }
+    passing = 0;
+}
+
+/**
+Function Name : stats_count
+
+Description : Adds 1 to a counter.
+
+Arguments :
+    (unsigned char) index - The STATS_ counter.
+
+Returns :
+    void
+
+Changes :
+    Stats - The counter is incremented.
+**/
+void stats_count(unsigned char index) {
+    counter[index]++;
+}
+
+/**
+Function Name : stats_add
+
+Description : Adds to a counter.
+
+Arguments :
+    (unsigned char) index - The STATS_ counter.
+    (unsigned int) n - The amount to add.
+
+Returns :
+    void
+
+Changes :
+    Stats - The counter is increased.
+**/
+void stats_add(unsigned char index, unsigned int n) {
+    counter[index] += n;
+}
+
+/**
+Function Name : stats_time
+
+Description : Records one run of a timed path: the run is put in the bucket of the highest power of
+    two not above its time, and the shortest and longest runs updated.
+
+Arguments :
+    (unsigned char) index - The STATS_TIMER_ timer.
+    (unsigned long) ms - The time the run took.
+
+Returns :
+    void
+
+Changes :
+    Stats - The timer's histogram and extremes are updated.
+**/
+void stats_time(unsigned char index, unsigned long ms) {
+    statsTimer* t = &timer[index];
+    unsigned char b = 0;
+
+    if (ms > 0xFFFF) {
+        ms = 0xFFFF;
+    }
+    if (ms < t->min) {
+        t->min = (unsigned int)ms;
+    }
+    if (ms > t->max) {
+        t->max = (unsigned int)ms;
+    }
+    while (ms != 0 && b < STATS_BUCKETS - 1) {
+        ms >>= 1;
+        b++;
+    }
+    t->bucket[b]++;
+}
+
+/**
+Function Name : stats_pass
+
+Description : Called once per pass of the executive, next to wdt_reset. Times the pass that just
+    ended; the first call only starts the timer.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Stats - The loop timer records the pass.
+**/
+void stats_pass(void) {
+    unsigned long now = sched_now();
+
+    if (passing) {
+        stats_time(STATS_TIMER_LOOP, now - lastPass);
+    }
+    lastPass = now;
+    passing = 1;
+}
+
+/**
+Function Name : writeTimer
+
+Description : Writes a timer as a JSON member: "name":{"min":..,"max":..,"hist":[..]}.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) index - The STATS_TIMER_ timer.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+static void writeTimer(strbuf* b, unsigned char index) {
+    statsTimer* t = &timer[index];
+    unsigned char i;
+
+    strbuf_putquoted_P(b, (const char*)pgm_read_ptr(&timerName[index]));
+    strbuf_puts_P(b, PSTR(":{"));
+    strbuf_putquoted_P(b, PSTR("min"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, t->min == 0xFFFF ? 0 : t->min);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("max"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, t->max);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("hist"));
+    strbuf_puts_P(b, PSTR(":["));
+    for (i = 0; i < STATS_BUCKETS; i++) {
+        if (i != 0) {
+            strbuf_putc(b, ',');
+        }
+        strbuf_putdec(b, t->bucket[i]);
+    }
+    strbuf_puts_P(b, PSTR("]}"));
+}
+
+/**
+Function Name : stats_write
+
+Description : Writes the JSON body of a GET /device/stats response:
+
+        {"uptime":ms,"idle":ms,"requests":{"get":n,...,"invalid":n},"bad_requests":n,
+         "log_records":n,"log_bytes":n,"config_writes":n,"alarms_posted":n,"alarms_merged":n,
+         "loop":{"min":ms,"max":ms,"hist":[n,...]},"fsm":{...},"wdt_margin":ms}
+
+    Times are in milliseconds. A negative wdt_margin means a pass outlasted the watchdog timeout.
+    The clock readings are passed in, so a body written twice, once to count its length, comes out
+    the same both times.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned long) now - sched_now(), reported as the uptime.
+    (unsigned long) idle - sched_idle_ms().
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void stats_write(strbuf* b, unsigned long now, unsigned long idle) {
+    unsigned char i;
+
+    strbuf_putc(b, '{');
+    strbuf_putquoted_P(b, PSTR("uptime"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, now);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("idle"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, idle);
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("requests"));
+    strbuf_puts_P(b, PSTR(":{"));
+    for (i = 0; i < STATS_COUNTERS; i++) {
+        if (i == STATS_REQUESTS) {
+            strbuf_puts_P(b, PSTR("},"));
+        } else if (i != 0) {
+            strbuf_putc(b, ',');
+        }
+        strbuf_putquoted_P(b, (const char*)pgm_read_ptr(&counterName[i]));
+        strbuf_putc(b, ':');
+        strbuf_putdec(b, counter[i]);
+    }
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("alarms_posted"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, alarmq_posted());
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("alarms_merged"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, alarmq_merged());
+    for (i = 0; i < STATS_TIMERS; i++) {
+        strbuf_putc(b, ',');
+        writeTimer(b, i);
+    }
+    strbuf_putc(b, ',');
+    strbuf_putquoted_P(b, PSTR("wdt_margin"));
+    strbuf_putc(b, ':');
+    strbuf_putdec(b, (long)STATS_WDT_TIMEOUT_MS - (long)timer[STATS_TIMER_LOOP].max);
+    strbuf_putc(b, '}');
+}
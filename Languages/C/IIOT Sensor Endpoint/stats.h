@@ -0,0 +1,56 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for stats.c; run-time counters and timers on the hot paths of the
+    executive, served as JSON by GET /device/stats. Requires strbuf.h.
+**/
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+//DEFINES:
+#define STATS_REQ_GET       0   //Counters, by index: GET /device
+#define STATS_REQ_BIN       1   //  GET /device.bin, or GET /device answered in binary
+#define STATS_REQ_LOG       2   //  GET /device/log
+#define STATS_REQ_SAMPLES   3   //  GET /device/samples
+#define STATS_REQ_EVENTS    4   //  GET /device/events
+#define STATS_REQ_STATS     5   //  GET /device/stats
+#define STATS_REQ_CONFIG    6   //  PUT /device/config
+#define STATS_REQ_RESET     7   //  PUT /device?reset=, either value
+#define STATS_REQ_DELETE    8   //  DELETE /device/log
+#define STATS_REQ_INVALID   9   //  Request lines matching no route
+#define STATS_REQUESTS      10  //  (number of request counters)
+#define STATS_BAD_REQUESTS  10  //  400 responses
+#define STATS_LOG_RECORDS   11  //  Log records written back by log_update
+#define STATS_LOG_BYTES     12  //  EEPROM bytes written by log_update
+#define STATS_CONFIG_WRITES 13  //  Config blocks written back by config_update
+#define STATS_COUNTERS      14
+
+#define STATS_TIMER_LOOP    0   //Timers, by index: pass of the executive, wdt_reset to wdt_reset
+#define STATS_TIMER_FSM     1   //  One requestFSM call
+#define STATS_TIMERS        2
+#define STATS_BUCKETS       8   //Histogram buckets of a timer: 0, 1, 2-3, 4-7, ... 32-63, 64+ ms
+
+#define STATS_WDT_TIMEOUT_MS 2000   //Timeout the board library's wdt_init sets; wdt.h does not export it
+
+//DECLARATIONS:
+void stats_init(void);  //Zero every counter and timer
+
+void stats_count(unsigned char counter);    //Add 1 to a counter
+
+void stats_add(unsigned char counter, unsigned int n);  //Add n to a counter
+
+void stats_time(unsigned char timer, unsigned long ms);     //Record one timed run
+
+void stats_pass(void);  //Time the pass of the executive that just ended
+
+void stats_write(strbuf* b, unsigned long now, unsigned long idle);   //Append the GET /device/stats JSON body
+
+#endif
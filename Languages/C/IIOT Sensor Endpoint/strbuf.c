@@ -0,0 +1,349 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Bounded text buffer used to pre-serialize response text in RAM. Characters that do
+    not fit are dropped and flagged in 'overflow' so the caller can fall back to another path.
+
+    A buffer initialized with strbuf_init_socket is a bulk socket writer instead: output collects in
+    RAM and is handed to the W5x with one socket_writebuf each time the buffer fills and when the
+    response is flushed, so a response costs a few large SPI transfers rather than one per token.
+**/
+
+//INCLUDES:
+#include <string.h>
+#include "socket.h"
+#include "fmt.h"
+#include "progmem.h"
+#include "strbuf.h"
+
+/**
+Function Name : strbuf_init
+
+Description : Attaches the storage to the buffer and empties it. A buffer with no storage (data 0)
+    only counts the characters written to it in 'len', to size text before it is written.
+
+Arguments :
+    (strbuf*) b - The buffer to initialize.
+    (char*) data - Storage for the buffer contents, or 0 to only count characters.
+    (unsigned int) size - Size of 'data' in characters.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_init(strbuf* b, char* data, unsigned int size) {
+    b->data = data;
+    b->len = 0;
+    b->size = size;
+    b->overflow = 0;
+    b->toSocket = 0;
+}
+
+/**
+Function Name : strbuf_init_socket
+
+Description : Attaches the storage to the buffer, empties it, and makes it flush to a socket
+    whenever it fills.
+
+Arguments :
+    (strbuf*) b - The buffer to initialize.
+    (char*) data - Storage for the buffer contents.
+    (unsigned int) size - Size of 'data' in characters.
+    (SOCKET) s - A SOCKET macro (unsigned char) representing the socket to write to.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_init_socket(strbuf* b, char* data, unsigned int size, SOCKET s) {
+    strbuf_init(b, data, size);
+    b->toSocket = 1;
+    b->s = s;
+}
+
+/**
+Function Name : strbuf_flush
+
+Description : Writes the contents of a socket buffer to its socket in one transfer and empties it.
+    Does nothing for a buffer that is not attached to a socket.
+
+Arguments :
+    (strbuf*) b - The buffer to flush.
+
+Returns :
+    void
+
+Changes :
+    Ethernet - Writes the buffered text to the Ethernet device.
+**/
+void strbuf_flush(strbuf* b) {
+    if (b->toSocket && b->len > 0) {
+        socket_writebuf(b->s, (unsigned char*)b->data, b->len);
+        b->len = 0;
+    }
+}
+
+/**
+Function Name : strbuf_putbuf
+
+Description : Appends a block of characters. On a socket buffer, a block that does not fit tops the
+    buffer up and flushes it, and a remainder at least as large as the whole buffer is written to the
+    socket directly instead of being copied through it.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (char*) src - The characters to append.
+    (unsigned int) n - The number of characters in 'src'.
+
+Returns :
+    void
+
+Changes :
+    Ethernet - May write buffered text to the Ethernet device.
+**/
+void strbuf_putbuf(strbuf* b, char* src, unsigned int n) {
+    unsigned int fill;
+
+    if (b->data == 0) {
+        b->len += n;
+        return;
+    }
+
+    if (b->toSocket && b->len + n > b->size) {
+        //Top the buffer up first, so every transfer but the last is a full one
+        fill = b->size - b->len;
+        memcpy(b->data + b->len, src, fill);
+        b->len = b->size;
+        src += fill;
+        n -= fill;
+        strbuf_flush(b);
+        if (n >= b->size) {
+            socket_writebuf(b->s, (unsigned char*)src, n);
+            return;
+        }
+    }
+    if (b->len + n > b->size) {
+        n = b->size - b->len;
+        b->overflow = 1;
+    }
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+/**
+Function Name : strbuf_putc
+
+Description : Appends a character to the buffer. If the buffer is full, a socket buffer is flushed
+    first; any other buffer flags an overflow and drops the character.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (char) c - The character to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putc(strbuf* b, char c) {
+    if (b->data == 0) {
+        b->len++;
+        return;
+    }
+    if (b->len == b->size && b->toSocket) {
+        strbuf_flush(b);
+    }
+    if (b->len < b->size) {
+        b->data[b->len++] = c;
+    } else {
+        b->overflow = 1;
+    }
+}
+
+/**
+Function Name : strbuf_puts
+
+Description : Appends a null terminated string to the buffer.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (char*) str - The string to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_puts(strbuf* b, char* str) {
+    while (*str != '\0') {
+        strbuf_putc(b, *str++);
+    }
+}
+
+/**
+Function Name : strbuf_putquoted
+
+Description : Appends a null terminated string surrounded by double quotes.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (char*) str - The string to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putquoted(strbuf* b, char* str) {
+    strbuf_putc(b, '"');
+    strbuf_puts(b, str);
+    strbuf_putc(b, '"');
+}
+
+/**
+Function Name : strbuf_puts_P
+
+Description : Appends a null terminated string kept in program memory, read a character at a time
+    so the string is never copied into SRAM.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (const char*) str - The string to append, in program memory (PSTR or a PROGMEM array).
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_puts_P(strbuf* b, const char* str) {
+    char c;
+
+    while ((c = pgm_read_byte(str++)) != '\0') {
+        strbuf_putc(b, c);
+    }
+}
+
+/**
+Function Name : strbuf_putquoted_P
+
+Description : Appends a null terminated string kept in program memory, surrounded by double quotes.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (const char*) str - The string to append, in program memory.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putquoted_P(strbuf* b, const char* str) {
+    strbuf_putc(b, '"');
+    strbuf_puts_P(b, str);
+    strbuf_putc(b, '"');
+}
+
+/**
+Function Name : strbuf_putdec
+
+Description : Appends a signed decimal number with no padding.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (long) value - The number to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putdec(strbuf* b, long value) {
+    char digits[FMT_DEC_MAX];
+    strbuf_putbuf(b, digits, fmt_dec(digits, value));
+}
+
+/**
+Function Name : strbuf_putdate
+
+Description : Appends a time as a quoted "MM/DD/YYYY HH:MM:SS" string, the form written by
+    rtc_num2datestr. Successive times are cheapest in increasing order (see fmt_date).
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned long) seconds - Seconds since 01/01/1970 00:00:00.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putdate(strbuf* b, unsigned long seconds) {
+    char text[FMT_DATE_LEN + 2];
+    text[0] = '"';
+    fmt_date(text + 1, seconds);
+    text[FMT_DATE_LEN + 1] = '"';
+    strbuf_putbuf(b, text, sizeof(text));
+}
+
+/**
+Function Name : strbuf_puthex8
+
+Description : Appends a byte as two upper case hex digits.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned char) value - The byte to append.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_puthex8(strbuf* b, unsigned char value) {
+    static const char hex[] PROGMEM = "0123456789ABCDEF";
+    strbuf_putc(b, pgm_read_byte(&hex[value >> 4]));
+    strbuf_putc(b, pgm_read_byte(&hex[value & 0x0F]));
+}
+
+/**
+Function Name : strbuf_putmac
+
+Description : Appends a MAC address in the quoted XX:XX:XX:XX:XX:XX form used by the socket library.
+
+Arguments :
+    (strbuf*) b - The buffer to write to.
+    (unsigned char*) mac - The six bytes of the MAC address.
+
+Returns :
+    void
+
+Changes :
+    N/A
+**/
+void strbuf_putmac(strbuf* b, unsigned char* mac) {
+    char text[FMT_MAC_LEN + 2];
+    text[0] = '"';
+    fmt_mac(text + 1, mac);
+    text[FMT_MAC_LEN + 1] = '"';
+    strbuf_putbuf(b, text, sizeof(text));
+}
@@ -0,0 +1,55 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for strbuf.c; a bounded text buffer in RAM with the same formatting
+    operations the socket library offers, so response text can be prepared ahead of time or
+    collected and sent to a socket in large chunks.
+**/
+#ifndef STRBUF_H_INCLUDED
+#define STRBUF_H_INCLUDED
+
+//DECLARATIONS:
+typedef struct {
+    char* data;                 //Backing storage
+    unsigned int len;           //Characters written so far
+    unsigned int size;          //Capacity of 'data'
+    unsigned char overflow;     //Set when a write did not fit
+    unsigned char toSocket;     //Flush to 's' when full instead of overflowing
+    unsigned char s;            //SOCKET the buffer flushes to
+} strbuf;
+
+void strbuf_init(strbuf* b, char* data, unsigned int size);    //Attach storage and empty the buffer
+
+void strbuf_init_socket(strbuf* b, char* data, unsigned int size, unsigned char s);    //Same, flushing to socket s
+
+void strbuf_flush(strbuf* b);   //Write a socket buffer's contents to its socket and empty it
+
+void strbuf_putbuf(strbuf* b, char* src, unsigned int n);   //Append a block of characters
+
+void strbuf_putc(strbuf* b, char c);     //Append a character
+
+void strbuf_puts(strbuf* b, char* str);  //Append a string
+
+void strbuf_putquoted(strbuf* b, char* str);     //Append a string in double quotes
+
+void strbuf_puts_P(strbuf* b, const char* str);     //Append a string kept in program memory
+
+void strbuf_putquoted_P(strbuf* b, const char* str);    //Append a string kept in program memory, in double quotes
+
+void strbuf_putdec(strbuf* b, long value);   //Append a signed decimal number
+
+void strbuf_putdate(strbuf* b, unsigned long seconds); //Append a quoted date in the rtc_num2datestr format
+
+void strbuf_puthex8(strbuf* b, unsigned char value); //Append two upper case hex digits
+
+void strbuf_putmac(strbuf* b, unsigned char* mac);   //Append a quoted MAC address
+
+#endif
@@ -0,0 +1,345 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Temperature state machine and classifier. Classifying a reading used to be done twice:
+    by the library FSM against the thresholds passed on every sample, and by getTempState against
+    config on every GET, each as a chain of comparisons. Here the four thresholds are turned into a
+    band table once, when they change, holding the lowest temperature of each band above
+    LOW_CRITICAL, and a reading is classified as the number of band starts it has reached: four
+    comparisons and three additions, the same for every temperature.
+
+    The state of the last sample is kept with the sample, and the GET responses report that sample
+    and state, so a response can never show a state that disagrees with the alarms that were raised.
+    When the thresholds change, the last sample is reclassified straight away rather than on the next
+    sample. Every change to a band other than NORMAL adds a log record and raises the band's alarm,
+    as the library FSM did; the alarm is queued and sent by the alarm queue (see alarmq.c).
+
+    With a hysteresis set (see filter.c), a move towards NORMAL only happens once the temperature is
+    that many degrees past the threshold it crossed on the way out; moves away from NORMAL are not
+    delayed, so an alarm is never late.
+**/
+
+//INCLUDES:
+#include "log.h"
+#include "alarmq.h"
+#include "tempfsm.h"
+#include "progmem.h"
+
+//DEFINES:
+#define TEMP_BANDS 4    //Band starts in the table; one fewer than the states
+
+//DECLARATIONS:
+static const unsigned char bandEvent[] = {EVENT_LO_ALARM, EVENT_LO_WARN, 0, EVENT_HI_WARN, EVENT_HI_ALARM};
+static const char lowCritical[] PROGMEM = "LOW_CRITICAL";
+static const char lowWarn[] PROGMEM = "LOW_WARN";
+static const char normal[] PROGMEM = "NORMAL";
+static const char highWarn[] PROGMEM = "HIGH_WARN";
+static const char highCritical[] PROGMEM = "HIGH_CRITICAL";
+static const char* const bandName[] PROGMEM = {lowCritical, lowWarn, normal, highWarn, highCritical};
+
+static int bandStart[TEMP_BANDS];   //Lowest temperature of LOW_WARN, NORMAL, HIGH_WARN and HIGH_CRITICAL
+static int sampleTemp;              //Last sample, or TEMPFSM_INITIAL_TEMP before the first
+static unsigned char sampleState;   //TEMP_ state of sampleTemp
+static unsigned char sampled;       //A sample has been taken since init or reset
+static int hysteresis;              //Degrees past a threshold needed to move towards NORMAL
+
+/**
+Function Name : tempfsm_classify
+
+Description : Classifies a temperature against the band table. Each comparison adds 1 for a band
+    start the temperature has reached, and the band starts are in increasing order, so the sum is the
+    TEMP_ state code.
+
+Arguments :
+    (int) temperature - The temperature to classify.
+
+Returns :
+    (unsigned char) - The state, TEMP_LOW_CRITICAL to TEMP_HIGH_CRITICAL.
+
+Changes :
+    N/A
+**/
+unsigned char tempfsm_classify(int temperature) {
+    return (unsigned char)((temperature >= bandStart[0]) + (temperature >= bandStart[1]) +
+                           (temperature >= bandStart[2]) + (temperature >= bandStart[3]));
+}
+
+/**
+Function Name : setBands
+
+Description : Rebuilds the band table if the thresholds differ from the ones it was built from. A
+    temperature at or below a low threshold is in the band below it, and one at or above a high
+    threshold is in the band above it.
+
+Arguments :
+    (int) hicrit - config.hi_alarm.
+    (int) hiwarn - config.hi_warn.
+    (int) locrit - config.lo_alarm.
+    (int) lowarn - config.lo_warn.
+
+Returns :
+    (unsigned char) - 1 if the table changed, otherwise 0.
+
+Changes :
+    Temp FSM - The band table is rebuilt.
+**/
+static unsigned char setBands(int hicrit, int hiwarn, int locrit, int lowarn) {
+    if (bandStart[0] == locrit + 1 && bandStart[1] == lowarn + 1 &&
+            bandStart[2] == hiwarn && bandStart[3] == hicrit) {
+        return 0;
+    }
+    bandStart[0] = locrit + 1;
+    bandStart[1] = lowarn + 1;
+    bandStart[2] = hiwarn;
+    bandStart[3] = hicrit;
+    return 1;
+}
+
+/**
+Function Name : classifyFrom
+
+Description : Classifies a temperature as tempfsm_classify does, but moves from the current state
+    towards NORMAL only as far as the temperature less the hysteresis (or plus it, above NORMAL)
+    would reach. A move that ends on the other side of NORMAL is the alarm of that side and is
+    taken at once.
+
+Arguments :
+    (int) temperature - The temperature to classify.
+    (unsigned char) from - The current state.
+
+Returns :
+    (unsigned char) - The new state, TEMP_LOW_CRITICAL to TEMP_HIGH_CRITICAL.
+
+Changes :
+    N/A
+**/
+static unsigned char classifyFrom(int temperature, unsigned char from) {
+    unsigned char next = tempfsm_classify(temperature);
+    unsigned char held;
+
+    if (hysteresis == 0) {
+        return next;
+    }
+    if (from < TEMP_NORMAL && next > from && next <= TEMP_NORMAL) {
+        held = tempfsm_classify(temperature - hysteresis);
+        next = held > from ? held : from;
+    } else if (from > TEMP_NORMAL && next < from && next >= TEMP_NORMAL) {
+        held = tempfsm_classify(temperature + hysteresis);
+        next = held < from ? held : from;
+    }
+    return next;
+}
+
+/**
+Function Name : step
+
+Description : Moves the FSM to the state of the last sample. Entering a band other than NORMAL, or
+    being in one at the first sample, logs the band's event and queues its alarm.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - sampleState is set to the classification of sampleTemp.
+    Log - A record is added for the band entered.
+    Alarm queue - The band's alarm is queued.
+**/
+static void step(void) {
+    unsigned char next = sampled ? classifyFrom(sampleTemp, sampleState) : tempfsm_classify(sampleTemp);
+
+    if ((next != sampleState || !sampled) && next != TEMP_NORMAL) {
+        log_add_record(bandEvent[next]);
+        alarmq_post(bandEvent[next]);
+    }
+    sampleState = next;
+}
+
+/**
+Function Name : tempfsm_init
+
+Description : Starts the FSM with no sample taken. Until tempfsm_set_thresholds or the first sample
+    loads the band table, every temperature classifies as HIGH_CRITICAL.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - The sample is set to TEMPFSM_INITIAL_TEMP and the band table is cleared.
+**/
+void tempfsm_init(void) {
+    unsigned char i;
+
+    for (i = 0; i < TEMP_BANDS; i++) {
+        bandStart[i] = -0x7FFF;
+    }
+    sampleTemp = TEMPFSM_INITIAL_TEMP;
+    sampleState = tempfsm_classify(sampleTemp);
+    sampled = 0;
+}
+
+/**
+Function Name : tempfsm_reset
+
+Description : Forgets the alarm state, so the next sample raises the alarm of its band again even if
+    the band has not changed. The last sample and its state are still reported.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - The FSM waits for a first sample.
+**/
+void tempfsm_reset(void) {
+    sampled = 0;
+}
+
+/**
+Function Name : tempfsm_update
+
+Description : Takes a new temperature sample, classifies it and steps the FSM. Called from the
+    sampling task with the config thresholds.
+
+Arguments :
+    (int) current - The temperature reading.
+    (int) hicrit - config.hi_alarm.
+    (int) hiwarn - config.hi_warn.
+    (int) locrit - config.lo_alarm.
+    (int) lowarn - config.lo_warn.
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - The sample and its state are replaced; the band table is rebuilt if the thresholds changed.
+    Log - A record is added if a band other than NORMAL is entered.
+    Alarm queue - An alarm is queued if a band other than NORMAL is entered.
+**/
+void tempfsm_update(int current, int hicrit, int hiwarn, int locrit, int lowarn) {
+    setBands(hicrit, hiwarn, locrit, lowarn);
+    sampleTemp = current;
+    step();
+    sampled = 1;
+}
+
+/**
+Function Name : tempfsm_set_thresholds
+
+Description : Loads new thresholds and reclassifies the last sample under them, so the state
+    reported and alarmed on follows a config change at once. Before the first sample the state is
+    reclassified without logging or alarms.
+
+Arguments :
+    (int) hicrit - config.hi_alarm.
+    (int) hiwarn - config.hi_warn.
+    (int) locrit - config.lo_alarm.
+    (int) lowarn - config.lo_warn.
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - The band table is rebuilt and the state of the last sample recomputed.
+    Log - A record is added if the new thresholds move the sample into a band other than NORMAL.
+    Alarm queue - An alarm is queued if the new thresholds move the sample into a band other than NORMAL.
+**/
+void tempfsm_set_thresholds(int hicrit, int hiwarn, int locrit, int lowarn) {
+    if (!setBands(hicrit, hiwarn, locrit, lowarn)) {
+        return;
+    }
+    if (sampled) {
+        step();
+    } else {
+        sampleState = tempfsm_classify(sampleTemp);
+    }
+}
+
+/**
+Function Name : tempfsm_set_hysteresis
+
+Description : Sets the hysteresis used for moves towards NORMAL. The current state is kept; the new
+    hysteresis applies from the next sample.
+
+Arguments :
+    (unsigned char) degrees - Degrees a temperature must be past a threshold to move back across it.
+
+Returns :
+    void
+
+Changes :
+    Temp FSM - The hysteresis is replaced.
+**/
+void tempfsm_set_hysteresis(unsigned char degrees) {
+    hysteresis = degrees;
+}
+
+/**
+Function Name : tempfsm_get_temperature
+
+Description : Returns the last sample.
+
+Arguments :
+    void
+
+Returns :
+    (int) - The temperature of the last sample, or TEMPFSM_INITIAL_TEMP before the first.
+
+Changes :
+    N/A
+**/
+int tempfsm_get_temperature(void) {
+    return sampleTemp;
+}
+
+/**
+Function Name : tempfsm_get_state
+
+Description : Returns the state of the last sample under the current thresholds.
+
+Arguments :
+    void
+
+Returns :
+    (unsigned char) - The state, TEMP_LOW_CRITICAL to TEMP_HIGH_CRITICAL.
+
+Changes :
+    N/A
+**/
+unsigned char tempfsm_get_state(void) {
+    return sampleState;
+}
+
+/**
+Function Name : tempfsm_state_name
+
+Description : Returns the name of a state as reported in the GET /device response. The name is kept
+    in program memory; write it with strbuf_putquoted_P.
+
+Arguments :
+    (unsigned char) state - A TEMP_ state code.
+
+Returns :
+    (const char*) - The state's name, in program memory.
+
+Changes :
+    N/A
+**/
+const char* tempfsm_state_name(unsigned char state) {
+    return (const char*)pgm_read_ptr(&bandName[state]);
+}
@@ -0,0 +1,48 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for tempfsm.c; the temperature state machine. Keeps the interface of the
+    board support library's tempfsm module and adds the classification and the cached state of the
+    last sample, so the responses and the alarms read one state instead of classifying separately.
+**/
+#ifndef TEMPFSM_H_INCLUDED
+#define TEMPFSM_H_INCLUDED
+
+//DEFINES:
+//Temperature state codes, in band order
+#define TEMP_LOW_CRITICAL 0
+#define TEMP_LOW_WARN 1
+#define TEMP_NORMAL 2
+#define TEMP_HIGH_WARN 3
+#define TEMP_HIGH_CRITICAL 4
+
+#define TEMPFSM_INITIAL_TEMP 75     //Temperature reported until the first sample is taken
+
+//DECLARATIONS:
+void tempfsm_init(void);    //Start with no sample; tempfsm_set_thresholds then loads the band table
+
+void tempfsm_reset(void);   //Forget the last alarm state; the next sample raises its band's alarm again
+
+void tempfsm_update(int current, int hicrit, int hiwarn, int locrit, int lowarn);   //Classify a new sample, logging and alarming on a band change
+
+void tempfsm_set_thresholds(int hicrit, int hiwarn, int locrit, int lowarn);   //Rebuild the band table and reclassify the last sample
+
+void tempfsm_set_hysteresis(unsigned char degrees);   //Degrees past a threshold needed to move back towards NORMAL
+
+unsigned char tempfsm_classify(int temperature);    //TEMP_ state of a temperature under the current band table
+
+int tempfsm_get_temperature(void);  //Temperature of the last sample
+
+unsigned char tempfsm_get_state(void);  //TEMP_ state of the last sample
+
+const char* tempfsm_state_name(unsigned char state);  //"LOW_CRITICAL" .. "HIGH_CRITICAL", in program memory
+
+#endif
@@ -0,0 +1,181 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Batched EEPROM write-back. A config change made through PUT /device/config is held in
+    RAM and written back once no further change has arrived for WRITEBACK_QUIET_MS, or
+    WRITEBACK_DEADLINE_MS after the first change that is still unwritten, whichever comes first. A
+    provisioning burst of threshold PUTs is therefore written with a single config_update, which
+    rewrites the whole config block, and the PUTs are answered at network speed while the block
+    waits. The deadline bounds how long a change can sit in RAM during a steady stream of PUTs.
+    Filter settings changed through the same PUTs join the batch, and only the blocks that changed
+    are written.
+
+    Log records are written back on every run of the task; log_update only writes the slots of new
+    records and skips unchanged bytes (see log.c).
+**/
+
+//INCLUDES:
+#include "config.h"
+#include "log.h"
+#include "filter.h"
+#include "sched.h"
+#include "strbuf.h"
+#include "stats.h"
+#include "writeback.h"
+
+//DEFINES:
+#define DIRTY_CONFIG    0x01    //The config thresholds changed
+#define DIRTY_FILTER    0x02    //The filter settings changed
+
+//DECLARATIONS:
+static unsigned char configDirty;   //DIRTY_ bits of the blocks in the batch
+static unsigned long firstChange;   //sched_now() of the first unwritten config change
+static unsigned long lastChange;    //sched_now() of the latest config change
+
+/**
+Function Name : noteChange
+
+Description : Notes a change to one of the blocks written back in the config batch, starting or
+    extending the batch.
+
+Arguments :
+    (unsigned char) block - The DIRTY_ bit of the block.
+
+Returns :
+    void
+
+Changes :
+    Write-back - The block is pending write-back.
+**/
+static void noteChange(unsigned char block) {
+    lastChange = sched_now();
+    if (!configDirty) {
+        firstChange = lastChange;
+    }
+    configDirty |= block;
+}
+
+/**
+Function Name : writeback_config_changed
+
+Description : Notes a change to the RAM copy of the config, starting or extending the batch it is
+    written back with.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Write-back - The config is pending write-back.
+**/
+void writeback_config_changed(void) {
+    noteChange(DIRTY_CONFIG);
+}
+
+/**
+Function Name : writeback_filter_changed
+
+Description : Notes a change to the filter settings, written back in the same batch as the config.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    Write-back - The filter settings are pending write-back.
+**/
+void writeback_filter_changed(void) {
+    noteChange(DIRTY_FILTER);
+}
+
+/**
+Function Name : writeBatch
+
+Description : Writes back the blocks of the config batch that changed and closes the batch.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - The config and the filter settings are written if they changed.
+    Stats - A config write is counted.
+**/
+static void writeBatch(void) {
+    if (configDirty & DIRTY_CONFIG) {
+        config_set_modified();
+        config_update();
+        stats_count(STATS_CONFIG_WRITES);
+    }
+    if (configDirty & DIRTY_FILTER) {
+        filter_update();
+    }
+    configDirty = 0;
+}
+
+/**
+Function Name : writeback_update
+
+Description : Scheduled task. Writes back new log records, and the config once its batch is due.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - New log records and a due config batch are written.
+**/
+void writeback_update(void) {
+    unsigned long now;
+
+    log_update();
+    if (configDirty) {
+        now = sched_now();
+        if (now - lastChange >= WRITEBACK_QUIET_MS || now - firstChange >= WRITEBACK_DEADLINE_MS) {
+            writeBatch();
+        }
+    }
+}
+
+/**
+Function Name : writeback_flush
+
+Description : Writes back the log and any pending config change without waiting for the batch to
+    come due. Used before a restart.
+
+Arguments :
+    void
+
+Returns :
+    void
+
+Changes :
+    EEPROM - Pending log records and config changes are written.
+**/
+void writeback_flush(void) {
+    log_update();
+    if (configDirty & DIRTY_CONFIG) {
+        config_set_modified();
+    }
+    if (configDirty & DIRTY_FILTER) {
+        filter_update();
+    }
+    configDirty = 0;
+    config_update();
+}
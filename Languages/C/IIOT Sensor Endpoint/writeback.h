@@ -0,0 +1,31 @@
+/**
+Author(s) : Jordan H. Bugai
+
+ASUrite : jbugai
+
+Course : SER486, Final Project
+
+Instructor : Professor Sandy
+
+Date : October 17th, 2026
+
+Description : Header file for writeback.c; batches the EEPROM write-back of the config, the filter
+    settings and the log so a burst of changes costs one write-back instead of one per change.
+**/
+#ifndef WRITEBACK_H_INCLUDED
+#define WRITEBACK_H_INCLUDED
+
+//DEFINES:
+#define WRITEBACK_QUIET_MS      250     //Config is written once it has not changed for this long
+#define WRITEBACK_DEADLINE_MS   2000    //or at the latest this long after its first unwritten change
+
+//DECLARATIONS:
+void writeback_config_changed(void);    //Note a change to the config thresholds
+
+void writeback_filter_changed(void);    //Note a change to the filter settings
+
+void writeback_update(void);    //Scheduled task: write back what is due
+
+void writeback_flush(void);     //Write back everything pending now
+
+#endif